@@ -0,0 +1,526 @@
+// ---------------------------------------------------------------------------
+//  Headless benchmark suite for the DiodeScout core library.
+//
+//  Measures the hot paths of the core library and emits the results as
+//  JSON on stdout (a human-readable summary goes to stderr), so numbers
+//  can be tracked across releases. Links only diodescout_core, so it runs
+//  on machines without Qt (e.g. CI).
+//
+//  - SerialParser throughput on clean and malformed synthetic streams, and
+//    with hand-off of the completed series to a data manager
+//  - CSV and Python export throughput
+//  - Binary session save, open and load
+//  - Piecewise-linear and Shockley model fit latency, single series and batch
+//  - Synthetic I–V generator throughput
+//  - Series storage churn (pooled sample columns)
+//  - Level-of-detail decimation for display
+//  - Column kernels for every supported instruction set level
+//
+//  Usage: diodescout_bench [--quick]
+// ---------------------------------------------------------------------------
+
+#include "columnkernels.h"
+#include "datamanager.h"
+#include "decimation.h"
+#include "ivgenerator.h"
+#include "serialparser.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+//  BenchmarkResult:
+//  Timing of a single benchmark case. Throughput figures are derived from
+//  the bytes and items processed per iteration (0 if not applicable).
+// ---------------------------------------------------------------------------
+struct BenchmarkResult
+{
+    std::string name;
+    std::size_t iterations;
+    double secondsPerIteration;
+    double bytesPerIteration;
+    double itemsPerIteration;
+};
+
+// ---------------------------------------------------------------------------
+//  Benchmark harness, collects results of all executed cases.
+// ---------------------------------------------------------------------------
+class BenchmarkRunner
+{
+  public:
+    // Constructs a runner that repeats each case for at least minSeconds.
+    explicit BenchmarkRunner(double minSeconds) :
+        minSeconds_(minSeconds)
+    {
+    }
+
+    // Runs body repeatedly and records its timing. bytes and items are
+    // the amounts processed by a single invocation of body.
+    void run(const std::string &name, double bytes, double items, const std::function<void()> &body)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        body(); // warm-up
+
+        std::size_t iterations = 0;
+        const auto start = Clock::now();
+        std::chrono::duration<double> elapsed{};
+        do
+        {
+            body();
+            ++iterations;
+            elapsed = Clock::now() - start;
+        } while (elapsed.count() < minSeconds_);
+
+        const BenchmarkResult r{name, iterations, elapsed.count() / iterations, bytes, items};
+        results_.push_back(r);
+
+        std::fprintf(stderr, "%-32s %10.3f us/iter", name.c_str(), r.secondsPerIteration * 1e6);
+        if (bytes > 0)
+            std::fprintf(stderr, " %10.1f MB/s", bytes / r.secondsPerIteration / 1e6);
+        if (items > 0)
+            std::fprintf(stderr, " %14.0f items/s", items / r.secondsPerIteration);
+        std::fprintf(stderr, "\n");
+    }
+
+    // Writes all results as a JSON document to out.
+    void writeJSON(std::FILE *out) const
+    {
+        std::fprintf(out, "{\n  \"benchmarks\": [\n");
+        for (std::size_t i = 0; i < results_.size(); ++i)
+        {
+            const auto &r = results_[i];
+            const double bytesPerSecond = r.bytesPerIteration / r.secondsPerIteration;
+            const double itemsPerSecond = r.itemsPerIteration / r.secondsPerIteration;
+
+            std::fprintf(out,
+                "    {\"name\": \"%s\", \"iterations\": %zu, \"seconds_per_iteration\": %.9g, "
+                "\"bytes_per_second\": %.6g, \"items_per_second\": %.6g}%s\n",
+                r.name.c_str(), r.iterations, r.secondsPerIteration, bytesPerSecond, itemsPerSecond,
+                i + 1 < results_.size() ? "," : "");
+        }
+        std::fprintf(out, "  ]\n}\n");
+    }
+
+  private:
+    // Minimum measurement time per case.
+    double minSeconds_;
+
+    // Results of all executed cases.
+    std::vector<BenchmarkResult> results_;
+};
+
+// ---------------------------------------------------------------------------
+//  Returns the generator settings for synthetic benchmark data.
+// ---------------------------------------------------------------------------
+static IVGeneratorSettings TestCurveSettings(std::size_t pointsPerSeries)
+{
+    IVGeneratorSettings s = IVGeneratorSettings::SiliconDiode();
+    s.pointsPerSeries = pointsPerSeries;
+    s.parameterSpread = 0.05;
+    s.currentNoise = 0.005;
+    return s;
+}
+
+// ---------------------------------------------------------------------------
+//  Builds a synthetic DiodeScout stream. Every corruptEvery-th line is
+//  replaced by malformed input (0 = clean stream). lineCount receives the
+//  number of lines in the stream.
+// ---------------------------------------------------------------------------
+static std::string MakeStream(int seriesCount, int pointsPerSeries, int corruptEvery, std::size_t &lineCount)
+{
+    static const char *const Malformed[] = {
+        "DATA 0.5x 1.0",
+        "DATA 1.0",
+        "DATA 99.0 1.0",
+        "GARBAGE-GARBAGE-GARBAGE-GARBAGE-GARBAGE-GARBAGE-GARBAGE-GARBAGE-GARBAGE-GARBAGE-GARBAGE-GARBAGE",
+    };
+
+    std::string stream;
+    char line[64];
+    lineCount = 0;
+
+    IVGenerator generator(TestCurveSettings(pointsPerSeries));
+    MeasurementSeries series;
+
+    auto appendLine = [&](const char *text)
+    {
+        ++lineCount;
+        if (corruptEvery > 0 && lineCount % corruptEvery == 0)
+            stream += Malformed[(lineCount / corruptEvery) % std::size(Malformed)];
+        else
+            stream += text;
+        stream += "\r\n";
+    };
+
+    for (int s = 0; s < seriesCount; ++s)
+    {
+        generator.generate(series);
+
+        appendLine("BEGIN");
+        for (std::size_t p = 0; p < series.size(); ++p)
+        {
+            std::snprintf(line, sizeof(line), "DATA %.3f %.3f", series.voltages()[p], series.currents()[p]);
+            appendLine(line);
+        }
+        appendLine("END");
+    }
+
+    return stream;
+}
+
+// ---------------------------------------------------------------------------
+//  Fills a data manager with synthetic series.
+// ---------------------------------------------------------------------------
+static void FillDataManager(MeasurementDataManager &dm, int seriesCount, int pointsPerSeries)
+{
+    IVGenerator generator(TestCurveSettings(pointsPerSeries));
+    dm.appendGeneratedSeries(generator, seriesCount);
+}
+
+// ---------------------------------------------------------------------------
+//  SerialParser throughput, chunked and per-character.
+// ---------------------------------------------------------------------------
+static void BenchmarkParser(BenchmarkRunner &runner, int scale)
+{
+    struct Case
+    {
+        const char *kind;
+        int seriesCount;
+        int corruptEvery;
+    };
+
+    const Case cases[] = {
+        {"clean", 1, 0},
+        {"clean", 10, 0},
+        {"clean", 10 * scale, 0},
+        {"malformed", 10 * scale, 7},
+    };
+
+    for (const auto &c : cases)
+    {
+        std::size_t lines = 0;
+        const std::string stream = MakeStream(c.seriesCount, 100, c.corruptEvery, lines);
+        const std::string name = std::string("parser/chunk/") + c.kind + "/" + std::to_string(c.seriesCount);
+
+        SerialParser parser;
+        runner.run(name, static_cast<double>(stream.size()), static_cast<double>(lines),
+            [&]()
+            {
+                std::string_view chunk(stream);
+                while (!chunk.empty())
+                {
+                    std::size_t consumed = 0;
+                    parser.processReceivedChunk(chunk, consumed);
+                    chunk.remove_prefix(consumed);
+                }
+            });
+    }
+
+    // High-resolution firmware, 1000 points per sweep
+    {
+        std::size_t lines = 0;
+        const std::string stream = MakeStream(scale, 1000, 0, lines);
+
+        BasicSerialParser<HighResolutionSerialLimits> parser;
+        runner.run("parser/chunk/highres/" + std::to_string(scale), static_cast<double>(stream.size()),
+            static_cast<double>(lines),
+            [&]()
+            {
+                std::string_view chunk(stream);
+                while (!chunk.empty())
+                {
+                    std::size_t consumed = 0;
+                    parser.processReceivedChunk(chunk, consumed);
+                    chunk.remove_prefix(consumed);
+                }
+            });
+    }
+
+    std::size_t lines = 0;
+    const std::string stream = MakeStream(100, 100, 0, lines);
+
+    SerialParser parser;
+    runner.run("parser/char/clean/100", static_cast<double>(stream.size()), static_cast<double>(lines),
+        [&]()
+        {
+            for (char ch : stream)
+                parser.processReceivedChar(ch);
+        });
+
+    // Parsing plus hand-off of every completed series into a data manager,
+    // as on the acquisition path
+    MeasurementDataManager dm;
+    runner.run("parser/handoff/100", static_cast<double>(stream.size()), static_cast<double>(lines),
+        [&]()
+        {
+            std::string_view chunk(stream);
+            while (!chunk.empty())
+            {
+                std::size_t consumed = 0;
+                const auto &events = parser.processReceivedChunk(chunk, consumed);
+                if (!events.empty() && events.back().result == ParseResult::SeriesCompleted)
+                {
+                    MeasurementSeries series(parser.currentSeries().size());
+                    parser.releaseSeries(series);
+                    dm.appendSeries(std::move(series));
+                }
+                chunk.remove_prefix(consumed);
+            }
+            dm.removeAllSeries();
+            dm.clearHistory();
+        });
+}
+
+// ---------------------------------------------------------------------------
+//  CSV and Python export throughput.
+// ---------------------------------------------------------------------------
+static void BenchmarkExport(BenchmarkRunner &runner, int scale)
+{
+    const int seriesCount = 10 * scale;
+    const int pointsPerSeries = 100;
+    const double points = static_cast<double>(seriesCount) * pointsPerSeries;
+
+    MeasurementDataManager dm;
+    FillDataManager(dm, seriesCount, pointsPerSeries);
+
+    const auto tmpDir = std::filesystem::temp_directory_path();
+    const std::string csvPath = (tmpDir / "diodescout_bench.csv").string();
+    const std::string pyPath = (tmpDir / "diodescout_bench.py").string();
+    const CSVSettings csv(',', ';');
+
+    const std::string suffix = "/" + std::to_string(seriesCount);
+    dm.exportCSV(csvPath, csv);
+    runner.run("export/csv" + suffix, static_cast<double>(std::filesystem::file_size(csvPath)), points,
+        [&]() { dm.exportCSV(csvPath, csv); });
+
+    dm.exportPython(pyPath);
+    runner.run("export/python" + suffix, static_cast<double>(std::filesystem::file_size(pyPath)), points,
+        [&]() { dm.exportPython(pyPath); });
+
+    std::error_code ec;
+    std::filesystem::remove(csvPath, ec);
+    std::filesystem::remove(pyPath, ec);
+}
+
+// ---------------------------------------------------------------------------
+//  Binary session save, open (index only) and full load.
+// ---------------------------------------------------------------------------
+static void BenchmarkSession(BenchmarkRunner &runner, int scale)
+{
+    const int seriesCount = 100 * scale;
+    const int pointsPerSeries = 100;
+    const double points = static_cast<double>(seriesCount) * pointsPerSeries;
+
+    MeasurementDataManager dm;
+    FillDataManager(dm, seriesCount, pointsPerSeries);
+
+    const std::string path = (std::filesystem::temp_directory_path() / "diodescout_bench.dss").string();
+    const std::string suffix = "/" + std::to_string(seriesCount);
+
+    dm.saveSession(path);
+    const auto bytes = static_cast<double>(std::filesystem::file_size(path));
+    runner.run("session/save" + suffix, bytes, points, [&]() { dm.saveSession(path); });
+
+    SessionReader reader;
+    runner.run("session/open" + suffix, 0, seriesCount, [&]() { reader.open(path); });
+    reader.close();
+
+    MeasurementDataManager loaded;
+    runner.run("session/load" + suffix, bytes, points,
+        [&]()
+        {
+            loaded.loadSession(path);
+            loaded.clearHistory();
+        });
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+}
+
+// ---------------------------------------------------------------------------
+//  Piecewise-linear and Shockley model latency.
+// ---------------------------------------------------------------------------
+static void BenchmarkPWL(BenchmarkRunner &runner)
+{
+    MeasurementDataManager dm;
+    FillDataManager(dm, 1, 100);
+
+    double forwardV = 0.0;
+    double seriesR = 0.0;
+    runner.run("analysis/pwl/100", 0, 100, [&]() { dm.computePWL(forwardV, seriesR); });
+
+    // Per-point updates of a whole series, as done during reception
+    IncrementalPWLFitter fitter;
+    PWLModel model;
+    runner.run("analysis/pwl-incremental/100", 0, 100,
+        [&]()
+        {
+            const MeasurementSeries &series = dm.allSeries().front();
+            fitter.reset();
+            for (std::size_t k = 0; k < series.size(); ++k)
+                fitter.addPoint(series.voltages()[k], series.currents()[k]);
+            model = fitter.model();
+        });
+
+    ShockleyFit fit;
+    runner.run("analysis/shockley/100", 0, 100, [&]() { FitShockleyModel(dm.allSeries().front(), fit); });
+}
+
+// ---------------------------------------------------------------------------
+//  Batch model fitting, single-threaded and on all cores.
+// ---------------------------------------------------------------------------
+static void BenchmarkBatchPWL(BenchmarkRunner &runner, int scale)
+{
+    const int seriesCount = 1000 * scale;
+
+    MeasurementDataManager dm;
+    FillDataManager(dm, seriesCount, 100);
+
+    const std::string suffix = "/" + std::to_string(seriesCount);
+    const double points = static_cast<double>(seriesCount) * 100;
+    runner.run("analysis/pwl-batch/1-thread" + suffix, 0, points, [&]() { dm.computeAllPWL(1); });
+    runner.run("analysis/pwl-batch/all-threads" + suffix, 0, points, [&]() { dm.computeAllPWL(); });
+    runner.run("analysis/shockley-batch/all-threads" + suffix, 0, points, [&]() { dm.computeAllShockley(); });
+}
+
+// ---------------------------------------------------------------------------
+//  Synthetic I–V generator throughput.
+// ---------------------------------------------------------------------------
+static void BenchmarkGenerator(BenchmarkRunner &runner, int scale)
+{
+    const int seriesCount = 10 * scale;
+    const int pointsPerSeries = 1000;
+
+    runner.run("generator/" + std::to_string(seriesCount) + "x" + std::to_string(pointsPerSeries), 0,
+        static_cast<double>(seriesCount) * pointsPerSeries,
+        [&]()
+        {
+            MeasurementDataManager dm;
+            FillDataManager(dm, seriesCount, pointsPerSeries);
+        });
+}
+
+// ---------------------------------------------------------------------------
+//  Series storage churn: storing and releasing many acquisition-sized
+//  series, as in a long session with repeated "Remove all series".
+// ---------------------------------------------------------------------------
+static void BenchmarkStorage(BenchmarkRunner &runner, int scale)
+{
+    const int seriesCount = 100 * scale;
+
+    MeasurementSeries series;
+    IVGenerator generator(TestCurveSettings(100));
+    generator.generate(series);
+
+    MeasurementDataManager dm;
+    runner.run("storage/churn/" + std::to_string(seriesCount), 0, seriesCount,
+        [&]()
+        {
+            for (int k = 0; k < seriesCount; ++k)
+                dm.appendSeries(series);
+            dm.removeAllSeries();
+            dm.clearHistory();
+        });
+}
+
+// ---------------------------------------------------------------------------
+//  Decimation of a dense series to the width of a plot, for the full and
+//  a zoomed-in view.
+// ---------------------------------------------------------------------------
+static void BenchmarkDecimation(BenchmarkRunner &runner, int scale)
+{
+    const int pointsPerSeries = 1000 * scale;
+    constexpr std::size_t PlotWidth = 1000;
+
+    MeasurementSeries series;
+    IVGenerator generator(TestCurveSettings(pointsPerSeries));
+    generator.generate(series);
+
+    MeasurementBounds zoomed;
+    zoomed.include(0.5, 0.0);
+    zoomed.include(0.7, 10.0);
+
+    std::vector<std::size_t> indices;
+    const auto n = static_cast<double>(pointsPerSeries);
+    runner.run("render/decimate/full/" + std::to_string(pointsPerSeries), n * 16, n,
+        [&]() { DecimateSeries(series, series.bounds(), PlotWidth, indices); });
+    runner.run("render/decimate/zoomed/" + std::to_string(pointsPerSeries), n * 16, n,
+        [&]() { DecimateSeries(series, zoomed, PlotWidth, indices); });
+}
+
+// ---------------------------------------------------------------------------
+//  Column kernel throughput per instruction set level.
+// ---------------------------------------------------------------------------
+static void BenchmarkKernels(BenchmarkRunner &runner, int scale)
+{
+    using Level = ColumnKernels::Level;
+
+    // One long column pair, like all curves of a large library
+    const std::size_t n = 10000 * static_cast<std::size_t>(scale);
+    SampleColumn x(n);
+    SampleColumn y(n);
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        x[k] = static_cast<double>(k % 1000) * 0.01;
+        y[k] = 0.6 + 0.001 * x[k];
+    }
+
+    const Level supported = ColumnKernels::supportedLevel();
+    for (Level level : {Level::Scalar, Level::SSE2, Level::AVX2})
+    {
+        if (level > supported)
+            break;
+
+        ColumnKernels::setLevel(level);
+        const std::string prefix = std::string("kernels/") + ColumnKernels::levelName(level) + "/";
+        const std::string suffix = "/" + std::to_string(n);
+        const double bytes = static_cast<double>(n * sizeof(double));
+
+        double mn = 0.0;
+        double mx = 0.0;
+        runner.run(prefix + "minmax" + suffix, bytes, static_cast<double>(n),
+            [&]() { ColumnKernels::minMax(x.data(), n, mn, mx); });
+
+        volatile double sink = 0.0;
+        runner.run(prefix + "dot" + suffix, 2 * bytes, static_cast<double>(n),
+            [&]() { sink = ColumnKernels::dot(x.data(), y.data(), n); });
+
+        RegressionSums r;
+        runner.run(prefix + "regression" + suffix, 2 * bytes, static_cast<double>(n),
+            [&]() { r = ColumnKernels::maskedRegressionSums(x.data(), y.data(), n, 5.0); });
+    }
+
+    ColumnKernels::setLevel(supported);
+}
+
+// ---------------------------------------------------------------------------
+//  Benchmark entry point.
+// ---------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    // --quick: smaller data sets and shorter runs, e.g. as a CI smoke test
+    const bool quick = (argc > 1 && std::strcmp(argv[1], "--quick") == 0);
+    const int scale = quick ? 10 : 100;
+
+    BenchmarkRunner runner(quick ? 0.02 : 0.5);
+    BenchmarkParser(runner, scale);
+    BenchmarkExport(runner, scale);
+    BenchmarkSession(runner, scale);
+    BenchmarkPWL(runner);
+    BenchmarkBatchPWL(runner, scale);
+    BenchmarkGenerator(runner, scale);
+    BenchmarkStorage(runner, scale);
+    BenchmarkDecimation(runner, scale);
+    BenchmarkKernels(runner, scale);
+
+    runner.writeJSON(stdout);
+    return 0;
+}
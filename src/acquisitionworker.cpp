@@ -0,0 +1,215 @@
+// ---------------------------------------------------------------------------
+//  Acquisition worker for the DiodeScout serial data stream.
+//
+//  Lives in a dedicated QThread together with the serial port, reads and
+//  parses all incoming data there and hands completed measurement series
+//  to the GUI thread through a lock-free queue. Chart redraws or modal
+//  dialogs on the GUI thread therefore never stall serial reception.
+//
+//  - Optionally call startRecording() to capture the raw byte stream
+//  - Move the worker and its device to the acquisition thread
+//  - On seriesAvailable(), drain the queue with takeCompletedSeries()
+//  - On liveSeriesChanged(), fetch the partial series with copyLiveSeries()
+//  - The piecewise-linear model of each series is updated per received
+//    point, so it is available together with the series
+//  - Call stop() before the acquisition thread is shut down
+// ---------------------------------------------------------------------------
+
+#include "acquisitionworker.h"
+#include <QDebug>
+#include <QThread>
+#include <QTimer>
+#include <utility>
+
+// Constructs a worker reading from device (e.g. an opened QSerialPort).
+AcquisitionWorker::AcquisitionWorker(QIODevice &device) :
+    device_(device),
+    completedQueue_(QueueCapacity)
+{
+    connect(&device_, &QIODevice::readyRead, this, &AcquisitionWorker::onReadyRead);
+}
+
+// Records all received data as timestamped chunks to a capture file.
+// Call before the worker is moved to the acquisition thread.
+// Returns true on success.
+bool AcquisitionWorker::startRecording(const std::string &filePath)
+{
+    if (!captureWriter_.open(filePath))
+        return false;
+
+    captureClock_.start();
+    return true;
+}
+
+// Moves the oldest completed series into series. Safe to call from the
+// GUI thread only. Returns false if no completed series is pending.
+bool AcquisitionWorker::takeCompletedSeries(MeasurementSeries &series)
+{
+    PWLModel pwl;
+    return takeCompletedSeries(series, pwl);
+}
+
+// Same as above, pwl receives the piecewise-linear model of the series.
+bool AcquisitionWorker::takeCompletedSeries(MeasurementSeries &series, PWLModel &pwl)
+{
+    if (!completedQueue_.tryPop(takenSeries_))
+        return false;
+
+    // Hand over the popped storage; the former storage of series (usually
+    // none, it was moved into the data manager) is released here
+    series = std::move(takenSeries_.series);
+    pwl = takenSeries_.pwl;
+    return true;
+}
+
+// Copies the series currently being received into series (empty if
+// none) when it changed since the last call. Safe to call from any
+// thread. Returns false if nothing changed.
+bool AcquisitionWorker::copyLiveSeries(MeasurementSeries &series)
+{
+    PWLModel pwl;
+    return copyLiveSeries(series, pwl);
+}
+
+// Same as above, pwl receives the piecewise-linear model of the points
+// received so far.
+bool AcquisitionWorker::copyLiveSeries(MeasurementSeries &series, PWLModel &pwl)
+{
+    std::lock_guard<std::mutex> lock(liveMutex_);
+    if (!liveSeriesChanged_)
+        return false;
+
+    series = liveSeries_; // reuses the capacity of series
+    pwl = livePWL_;
+    liveSeriesChanged_ = false;
+    return true;
+}
+
+// Stops reading and moves the device to targetThread.
+// Must be invoked on the acquisition thread.
+void AcquisitionWorker::stop(QThread *targetThread)
+{
+    disconnect(&device_, nullptr, this, nullptr);
+    device_.moveToThread(targetThread);
+}
+
+// Reads all available data and forwards it to the SerialParser.
+void AcquisitionWorker::onReadyRead()
+{
+    const QByteArray data = device_.readAll();
+    std::string_view chunk(data.constData(), static_cast<std::size_t>(data.size()));
+    bool pointsAdded = false;
+    bool seriesCompleted = false;
+
+    // Raw capture for later replay
+    if (captureWriter_.isOpen())
+    {
+        const auto timestamp = static_cast<std::uint64_t>(captureClock_.nsecsElapsed() / 1000);
+        if (!captureWriter_.write(timestamp, chunk))
+        {
+            qWarning() << "Capture file write failed, recording stopped";
+            captureWriter_.close();
+        }
+    }
+
+    std::size_t chunkOffset = 0; // of chunk within data
+    while (!chunk.empty())
+    {
+        std::size_t consumed = 0;
+        const auto &events = serialParser_.processReceivedChunk(chunk, consumed);
+        updatePWLFit();
+
+        for (const auto &event : events)
+        {
+            switch (event.result)
+            {
+            case ParseResult::SeriesCompleted:
+            {
+                // Move the series out of the parser, which continues with a
+                // fresh buffer sized like the completed series
+                MeasurementSeries series(serialParser_.currentSeries().size());
+                serialParser_.releaseSeries(series);
+                backlog_.push_back(CompletedSeries{std::move(series), pwlFitter_.model()});
+                seriesCompleted = true;
+                break;
+            }
+
+            case ParseResult::DataPointAdded:
+                pointsAdded = true;
+                break;
+
+            case ParseResult::ParseError:
+                // Event offsets are relative to the processed part of data
+                qWarning() << "ParseError at offset" << chunkOffset + event.offset << ":" << data;
+                break;
+
+            case ParseResult::Nothing:
+                break;
+            }
+        }
+
+        chunk.remove_prefix(consumed);
+        chunkOffset += consumed;
+    }
+
+    if (seriesCompleted)
+        publishSeries();
+
+    if (pointsAdded || seriesCompleted)
+        publishLiveSeries();
+}
+
+// Moves backlogged series into the hand-off queue.
+void AcquisitionWorker::publishSeries()
+{
+    bool published = false;
+    while (!backlog_.empty() && completedQueue_.tryPush(std::move(backlog_.front())))
+    {
+        backlog_.pop_front();
+        published = true;
+    }
+
+    // GUI thread is busy (e.g. modal dialog), try again later
+    if (!backlog_.empty())
+        QTimer::singleShot(PublishRetryInterval, this, &AcquisitionWorker::publishSeries);
+
+    if (published)
+        emit seriesAvailable();
+}
+
+// Publishes a snapshot of the series currently being received.
+void AcquisitionWorker::publishLiveSeries()
+{
+    {
+        std::lock_guard<std::mutex> lock(liveMutex_);
+        if (serialParser_.receivingSeries())
+        {
+            liveSeries_ = serialParser_.currentSeries();
+            livePWL_ = pwlFitter_.model();
+        }
+        else
+        {
+            liveSeries_.clear();
+            livePWL_ = PWLModel{};
+        }
+        liveSeriesChanged_ = true;
+    }
+
+    emit liveSeriesChanged();
+}
+
+// Feeds points parsed since the last call into pwlFitter_. A chunk may
+// hold many points, each of them is added exactly once.
+void AcquisitionWorker::updatePWLFit()
+{
+    // A new series started (possibly a resync within the same chunk)
+    if (serialParser_.seriesSequence() != pwlFitSequence_)
+    {
+        pwlFitter_.reset();
+        pwlFitSequence_ = serialParser_.seriesSequence();
+    }
+
+    const MeasurementSeries &series = serialParser_.currentSeries();
+    for (std::size_t k = pwlFitter_.pointCount(); k < series.size(); ++k)
+        pwlFitter_.addPoint(series.voltages()[k], series.currents()[k]);
+}
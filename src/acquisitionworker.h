@@ -0,0 +1,135 @@
+// ---------------------------------------------------------------------------
+//  Acquisition worker for the DiodeScout serial data stream.
+//
+//  Lives in a dedicated QThread together with the serial port, reads and
+//  parses all incoming data there and hands completed measurement series
+//  to the GUI thread through a lock-free queue. Chart redraws or modal
+//  dialogs on the GUI thread therefore never stall serial reception.
+//
+//  - Optionally call startRecording() to capture the raw byte stream
+//  - Move the worker and its device to the acquisition thread
+//  - On seriesAvailable(), drain the queue with takeCompletedSeries()
+//  - On liveSeriesChanged(), fetch the partial series with copyLiveSeries()
+//  - The piecewise-linear model of each series is updated per received
+//    point, so it is available together with the series
+//  - Call stop() before the acquisition thread is shut down
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+#include "capturefile.h"
+#include "pwlfitter.h"
+#include "serialparser.h"
+#include "spscqueue.h"
+#include <QElapsedTimer>
+#include <QIODevice>
+#include <QObject>
+#include <deque>
+#include <mutex>
+
+// ---------------------------------------------------------------------------
+//  CompletedSeries:
+//  A completed measurement series and its piecewise-linear model.
+// ---------------------------------------------------------------------------
+struct CompletedSeries
+{
+    MeasurementSeries series;
+    PWLModel pwl;
+};
+
+// ---------------------------------------------------------------------------
+//  AcquisitionWorker:
+//  Reads and parses serial data on the acquisition thread.
+// ---------------------------------------------------------------------------
+class AcquisitionWorker : public QObject
+{
+    Q_OBJECT
+
+  private:
+    // Capacity of the hand-off queue; overflow is kept in a local backlog.
+    static constexpr std::size_t QueueCapacity = 64;
+
+    // Delay before retrying to publish backlogged series (ms).
+    static constexpr int PublishRetryInterval = 100;
+
+  public:
+    // Constructs a worker reading from device (e.g. an opened QSerialPort).
+    explicit AcquisitionWorker(QIODevice &device);
+
+    // Records all received data as timestamped chunks to a capture file.
+    // Call before the worker is moved to the acquisition thread.
+    // Returns true on success.
+    bool startRecording(const std::string &filePath);
+
+    // Moves the oldest completed series into series. Safe to call from the
+    // GUI thread only. Returns false if no completed series is pending.
+    bool takeCompletedSeries(MeasurementSeries &series);
+
+    // Same as above, pwl receives the piecewise-linear model of the series.
+    bool takeCompletedSeries(MeasurementSeries &series, PWLModel &pwl);
+
+    // Copies the series currently being received into series (empty if
+    // none) when it changed since the last call. Safe to call from any
+    // thread. Returns false if nothing changed.
+    bool copyLiveSeries(MeasurementSeries &series);
+
+    // Same as above, pwl receives the piecewise-linear model of the points
+    // received so far.
+    bool copyLiveSeries(MeasurementSeries &series, PWLModel &pwl);
+
+  public slots:
+    // Stops reading and moves the device to targetThread.
+    // Must be invoked on the acquisition thread.
+    void stop(QThread *targetThread);
+
+  signals:
+    // Emitted when completed series are ready in the hand-off queue.
+    void seriesAvailable();
+
+    // Emitted after a received block changed the series being received.
+    void liveSeriesChanged();
+
+  private slots:
+    // Reads all available data and forwards it to the SerialParser.
+    void onReadyRead();
+
+    // Moves backlogged series into the hand-off queue.
+    void publishSeries();
+
+    // Publishes a snapshot of the series currently being received.
+    void publishLiveSeries();
+
+  private:
+    // Data source, owned by the caller.
+    QIODevice &device_;
+
+    // Parses incoming serial data.
+    SerialParser serialParser_;
+
+    // Raw capture of the received data (if recording).
+    CaptureWriter captureWriter_;
+    QElapsedTimer captureClock_;
+
+    // Piecewise-linear fit of the series being received, and the parser
+    // series it belongs to (see SerialParser::seriesSequence()).
+    IncrementalPWLFitter pwlFitter_;
+    std::uint64_t pwlFitSequence_ = 0;
+
+    // Completed series handed to the GUI thread.
+    SpscQueue<CompletedSeries> completedQueue_;
+
+    // Completed series not yet published because the queue was full.
+    std::deque<CompletedSeries> backlog_;
+
+    // Receives popped series in takeCompletedSeries() (GUI thread only).
+    CompletedSeries takenSeries_;
+
+    // Snapshot of the series being received, guarded by liveMutex_.
+    std::mutex liveMutex_;
+    MeasurementSeries liveSeries_;
+    PWLModel livePWL_;
+    bool liveSeriesChanged_ = false;
+
+    // Feeds points parsed since the last call into pwlFitter_.
+    void updatePWLFit();
+};
@@ -0,0 +1,121 @@
+// ---------------------------------------------------------------------------
+//  Raw serial capture files
+//
+//  Records the byte stream received from a DiodeScout device as a sequence
+//  of timestamped chunks, so field issues can be reproduced and the
+//  acquisition path can be replayed and load-tested later.
+//
+//  File layout (all integers little-endian):
+//  - 8 byte magic "DSCAPT01"
+//  - Records: uint64 timestamp (us since start), uint32 length, bytes
+// ---------------------------------------------------------------------------
+
+// Portable core module, no Qt dependencies.
+#include "capturefile.h"
+#include <cstring>
+#include <limits>
+
+// File identification and format version.
+static constexpr char CaptureMagic[8] = {'D', 'S', 'C', 'A', 'P', 'T', '0', '1'};
+
+// Size of a record header (timestamp + length).
+static constexpr std::size_t RecordHeaderSize = 12;
+
+// Stores value as little-endian bytes.
+static void PutLE(unsigned char *dst, std::uint64_t value, std::size_t bytes)
+{
+    for (std::size_t i = 0; i < bytes; ++i)
+        dst[i] = static_cast<unsigned char>(value >> (8 * i));
+}
+
+// Loads a little-endian value.
+static std::uint64_t GetLE(const unsigned char *src, std::size_t bytes)
+{
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < bytes; ++i)
+        value |= static_cast<std::uint64_t>(src[i]) << (8 * i);
+    return value;
+}
+
+// Creates (or truncates) a capture file and writes its header.
+// Returns true on success.
+bool CaptureWriter::open(const std::string &filePath)
+{
+    out_.open(filePath, std::ios::binary | std::ios::trunc);
+    if (!out_)
+        return false;
+
+    out_.write(CaptureMagic, sizeof(CaptureMagic));
+    out_.flush();
+    return out_.good();
+}
+
+// Returns true if a capture file is open.
+bool CaptureWriter::isOpen() const
+{
+    return out_.is_open();
+}
+
+// Appends a chunk and flushes it to the file.
+// Returns true on success.
+bool CaptureWriter::write(std::uint64_t timestampMicros, std::string_view data)
+{
+    if (data.size() > std::numeric_limits<std::uint32_t>::max())
+        return false;
+
+    unsigned char header[RecordHeaderSize];
+    PutLE(header, timestampMicros, 8);
+    PutLE(header + 8, data.size(), 4);
+
+    // Flush per chunk, a capture is most useful right after a crash
+    out_.write(reinterpret_cast<const char *>(header), sizeof(header));
+    out_.write(data.data(), static_cast<std::streamsize>(data.size()));
+    out_.flush();
+    return out_.good();
+}
+
+// Closes the capture file.
+void CaptureWriter::close()
+{
+    out_.close();
+}
+
+// Opens a capture file and validates its header.
+// Returns true on success.
+bool CaptureReader::open(const std::string &filePath)
+{
+    in_.open(filePath, std::ios::binary | std::ios::ate);
+    if (!in_)
+        return false;
+
+    const std::streamoff size = in_.tellg();
+    in_.seekg(0);
+    if (size < static_cast<std::streamoff>(sizeof(CaptureMagic)))
+        return false;
+    remaining_ = static_cast<std::uint64_t>(size) - sizeof(CaptureMagic);
+
+    char magic[sizeof(CaptureMagic)];
+    in_.read(magic, sizeof(magic));
+    return in_.good() && std::memcmp(magic, CaptureMagic, sizeof(magic)) == 0;
+}
+
+// Reads the next chunk. Returns false at the end of the file or if
+// the remaining data is truncated (or its length is corrupt).
+bool CaptureReader::next(CaptureChunk &chunk)
+{
+    unsigned char header[RecordHeaderSize];
+    if (remaining_ < sizeof(header) || !in_.read(reinterpret_cast<char *>(header), sizeof(header)))
+        return false;
+    remaining_ -= sizeof(header);
+
+    // A length beyond the end of the file is a truncated (or corrupt)
+    // record, it ends the capture before anything is allocated
+    const std::uint64_t length = GetLE(header + 8, 4);
+    if (length > remaining_)
+        return false;
+    remaining_ -= length;
+
+    chunk.timestampMicros = GetLE(header, 8);
+    chunk.data.resize(static_cast<std::size_t>(length));
+    return static_cast<bool>(in_.read(chunk.data.data(), static_cast<std::streamsize>(chunk.data.size())));
+}
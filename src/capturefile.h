@@ -0,0 +1,78 @@
+// ---------------------------------------------------------------------------
+//  Raw serial capture files
+//
+//  Records the byte stream received from a DiodeScout device as a sequence
+//  of timestamped chunks, so field issues can be reproduced and the
+//  acquisition path can be replayed and load-tested later.
+//
+//  File layout (all integers little-endian):
+//  - 8 byte magic "DSCAPT01"
+//  - Records: uint64 timestamp (us since start), uint32 length, bytes
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+// Portable core module, no Qt dependencies.
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+// ---------------------------------------------------------------------------
+//  CaptureChunk:
+//  A block of received bytes and its arrival time.
+// ---------------------------------------------------------------------------
+struct CaptureChunk
+{
+    std::uint64_t timestampMicros = 0; // since start of the capture
+    std::string data;
+};
+
+// ---------------------------------------------------------------------------
+//  CaptureWriter:
+//  Appends timestamped chunks to a capture file.
+// ---------------------------------------------------------------------------
+class CaptureWriter
+{
+  public:
+    // Creates (or truncates) a capture file and writes its header.
+    // Returns true on success.
+    bool open(const std::string &filePath);
+
+    // Returns true if a capture file is open.
+    bool isOpen() const;
+
+    // Appends a chunk and flushes it to the file.
+    // Returns true on success.
+    bool write(std::uint64_t timestampMicros, std::string_view data);
+
+    // Closes the capture file.
+    void close();
+
+  private:
+    // Output file.
+    std::ofstream out_;
+};
+
+// ---------------------------------------------------------------------------
+//  CaptureReader:
+//  Reads the chunks of a capture file in order.
+// ---------------------------------------------------------------------------
+class CaptureReader
+{
+  public:
+    // Opens a capture file and validates its header.
+    // Returns true on success.
+    bool open(const std::string &filePath);
+
+    // Reads the next chunk. Returns false at the end of the file or if
+    // the remaining data is truncated (or its length is corrupt).
+    bool next(CaptureChunk &chunk);
+
+  private:
+    // Input file.
+    std::ifstream in_;
+
+    // Bytes of the file not read yet.
+    std::uint64_t remaining_ = 0;
+};
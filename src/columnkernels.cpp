@@ -0,0 +1,335 @@
+// ---------------------------------------------------------------------------
+//  Vectorized kernels over measurement sample columns.
+//
+//  Reductions used by the analysis code (min/max, dot products and masked
+//  regression sums) with SSE2 and AVX2 implementations on x86 and
+//  a portable scalar fallback. The best implementation supported by the
+//  CPU is selected at runtime on first use.
+//
+//  SSE2 is part of the x86-64 baseline. The AVX2 kernels are compiled with
+//  a per-function target attribute (GCC/Clang), so the rest of the build
+//  keeps running on CPUs without AVX2.
+// ---------------------------------------------------------------------------
+
+// Portable core module, no Qt dependencies.
+#include "columnkernels.h"
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+#define COLUMNKERNELS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(COLUMNKERNELS_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define COLUMNKERNELS_AVX2 1
+#define COLUMNKERNELS_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+
+// ---------------------------------------------------------------------------
+//  Scalar kernels, reference implementation and fallback.
+// ---------------------------------------------------------------------------
+
+static void ScalarMinMax(const double *values, std::size_t n, double &minValue, double &maxValue) noexcept
+{
+    double mn = std::numeric_limits<double>::infinity();
+    double mx = -std::numeric_limits<double>::infinity();
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        mn = std::min(mn, values[k]);
+        mx = std::max(mx, values[k]);
+    }
+    minValue = mn;
+    maxValue = mx;
+}
+
+static double ScalarDot(const double *a, const double *b, std::size_t n) noexcept
+{
+    double s = 0.0;
+    for (std::size_t k = 0; k < n; ++k)
+        s += a[k] * b[k];
+    return s;
+}
+
+static RegressionSums ScalarRegressionSums(const double *x, const double *y, std::size_t n, double threshold) noexcept
+{
+    RegressionSums r;
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        if (!(x[k] >= threshold))
+            continue;
+
+        ++r.count;
+        r.sumX += x[k];
+        r.sumY += y[k];
+        r.sumXY += x[k] * y[k];
+        r.sumXX += x[k] * x[k];
+    }
+    return r;
+}
+
+// ---------------------------------------------------------------------------
+//  SSE2 kernels, two doubles per operation.
+// ---------------------------------------------------------------------------
+#ifdef COLUMNKERNELS_SSE2
+
+static double HorizontalSum(__m128d v) noexcept
+{
+    return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+}
+
+static void Sse2MinMax(const double *values, std::size_t n, double &minValue, double &maxValue) noexcept
+{
+    __m128d mn = _mm_set1_pd(std::numeric_limits<double>::infinity());
+    __m128d mx = _mm_set1_pd(-std::numeric_limits<double>::infinity());
+
+    std::size_t k = 0;
+    for (; k + 2 <= n; k += 2)
+    {
+        const __m128d v = _mm_loadu_pd(values + k);
+        mn = _mm_min_pd(mn, v);
+        mx = _mm_max_pd(mx, v);
+    }
+
+    double tailMin = 0.0;
+    double tailMax = 0.0;
+    ScalarMinMax(values + k, n - k, tailMin, tailMax);
+    minValue = std::min({_mm_cvtsd_f64(mn), _mm_cvtsd_f64(_mm_unpackhi_pd(mn, mn)), tailMin});
+    maxValue = std::max({_mm_cvtsd_f64(mx), _mm_cvtsd_f64(_mm_unpackhi_pd(mx, mx)), tailMax});
+}
+
+static double Sse2Dot(const double *a, const double *b, std::size_t n) noexcept
+{
+    __m128d s = _mm_setzero_pd();
+    std::size_t k = 0;
+    for (; k + 2 <= n; k += 2)
+        s = _mm_add_pd(s, _mm_mul_pd(_mm_loadu_pd(a + k), _mm_loadu_pd(b + k)));
+    return HorizontalSum(s) + ScalarDot(a + k, b + k, n - k);
+}
+
+static RegressionSums Sse2RegressionSums(const double *x, const double *y, std::size_t n, double threshold) noexcept
+{
+    const __m128d limit = _mm_set1_pd(threshold);
+    const __m128d one = _mm_set1_pd(1.0);
+    __m128d count = _mm_setzero_pd();
+    __m128d sx = _mm_setzero_pd();
+    __m128d sy = _mm_setzero_pd();
+    __m128d sxy = _mm_setzero_pd();
+    __m128d sxx = _mm_setzero_pd();
+
+    // Deselected lanes are zeroed instead of branched over
+    std::size_t k = 0;
+    for (; k + 2 <= n; k += 2)
+    {
+        const __m128d vx = _mm_loadu_pd(x + k);
+        const __m128d mask = _mm_cmpge_pd(vx, limit);
+        const __m128d mx = _mm_and_pd(mask, vx);
+        const __m128d my = _mm_and_pd(mask, _mm_loadu_pd(y + k));
+        count = _mm_add_pd(count, _mm_and_pd(mask, one));
+        sx = _mm_add_pd(sx, mx);
+        sy = _mm_add_pd(sy, my);
+        sxy = _mm_add_pd(sxy, _mm_mul_pd(mx, my));
+        sxx = _mm_add_pd(sxx, _mm_mul_pd(mx, mx));
+    }
+
+    RegressionSums r = ScalarRegressionSums(x + k, y + k, n - k, threshold);
+    r.count += static_cast<std::size_t>(HorizontalSum(count));
+    r.sumX += HorizontalSum(sx);
+    r.sumY += HorizontalSum(sy);
+    r.sumXY += HorizontalSum(sxy);
+    r.sumXX += HorizontalSum(sxx);
+    return r;
+}
+
+#endif // COLUMNKERNELS_SSE2
+
+// ---------------------------------------------------------------------------
+//  AVX2 kernels, four doubles per operation.
+// ---------------------------------------------------------------------------
+#ifdef COLUMNKERNELS_AVX2
+
+COLUMNKERNELS_TARGET_AVX2 static double HorizontalSum(__m256d v) noexcept
+{
+    const __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+COLUMNKERNELS_TARGET_AVX2 static void Avx2MinMax(
+    const double *values, std::size_t n, double &minValue, double &maxValue) noexcept
+{
+    __m256d mn = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    __m256d mx = _mm256_set1_pd(-std::numeric_limits<double>::infinity());
+
+    std::size_t k = 0;
+    for (; k + 4 <= n; k += 4)
+    {
+        const __m256d v = _mm256_loadu_pd(values + k);
+        mn = _mm256_min_pd(mn, v);
+        mx = _mm256_max_pd(mx, v);
+    }
+
+    alignas(32) double lanesMin[4];
+    alignas(32) double lanesMax[4];
+    _mm256_store_pd(lanesMin, mn);
+    _mm256_store_pd(lanesMax, mx);
+
+    double tailMin = 0.0;
+    double tailMax = 0.0;
+    ScalarMinMax(values + k, n - k, tailMin, tailMax);
+    minValue = std::min({lanesMin[0], lanesMin[1], lanesMin[2], lanesMin[3], tailMin});
+    maxValue = std::max({lanesMax[0], lanesMax[1], lanesMax[2], lanesMax[3], tailMax});
+}
+
+COLUMNKERNELS_TARGET_AVX2 static double Avx2Dot(const double *a, const double *b, std::size_t n) noexcept
+{
+    __m256d s = _mm256_setzero_pd();
+    std::size_t k = 0;
+    for (; k + 4 <= n; k += 4)
+        s = _mm256_add_pd(s, _mm256_mul_pd(_mm256_loadu_pd(a + k), _mm256_loadu_pd(b + k)));
+    return HorizontalSum(s) + ScalarDot(a + k, b + k, n - k);
+}
+
+COLUMNKERNELS_TARGET_AVX2 static RegressionSums Avx2RegressionSums(
+    const double *x, const double *y, std::size_t n, double threshold) noexcept
+{
+    const __m256d limit = _mm256_set1_pd(threshold);
+    const __m256d one = _mm256_set1_pd(1.0);
+    __m256d count = _mm256_setzero_pd();
+    __m256d sx = _mm256_setzero_pd();
+    __m256d sy = _mm256_setzero_pd();
+    __m256d sxy = _mm256_setzero_pd();
+    __m256d sxx = _mm256_setzero_pd();
+
+    // Deselected lanes are zeroed instead of branched over
+    std::size_t k = 0;
+    for (; k + 4 <= n; k += 4)
+    {
+        const __m256d vx = _mm256_loadu_pd(x + k);
+        const __m256d mask = _mm256_cmp_pd(vx, limit, _CMP_GE_OQ);
+        const __m256d mx = _mm256_and_pd(mask, vx);
+        const __m256d my = _mm256_and_pd(mask, _mm256_loadu_pd(y + k));
+        count = _mm256_add_pd(count, _mm256_and_pd(mask, one));
+        sx = _mm256_add_pd(sx, mx);
+        sy = _mm256_add_pd(sy, my);
+        sxy = _mm256_add_pd(sxy, _mm256_mul_pd(mx, my));
+        sxx = _mm256_add_pd(sxx, _mm256_mul_pd(mx, mx));
+    }
+
+    RegressionSums r = ScalarRegressionSums(x + k, y + k, n - k, threshold);
+    r.count += static_cast<std::size_t>(HorizontalSum(count));
+    r.sumX += HorizontalSum(sx);
+    r.sumY += HorizontalSum(sy);
+    r.sumXY += HorizontalSum(sxy);
+    r.sumXX += HorizontalSum(sxx);
+    return r;
+}
+
+#endif // COLUMNKERNELS_AVX2
+
+// ---------------------------------------------------------------------------
+//  Runtime dispatch.
+// ---------------------------------------------------------------------------
+
+// Returns the level in use, initialized with the supported level.
+static std::atomic<ColumnKernels::Level> &ActiveLevel() noexcept
+{
+    static std::atomic<ColumnKernels::Level> level{ColumnKernels::supportedLevel()};
+    return level;
+}
+
+// Returns the best level supported by this CPU and build.
+ColumnKernels::Level ColumnKernels::supportedLevel() noexcept
+{
+#if defined(COLUMNKERNELS_AVX2)
+    if (__builtin_cpu_supports("avx2"))
+        return Level::AVX2;
+#endif
+#if defined(COLUMNKERNELS_SSE2)
+    return Level::SSE2;
+#else
+    return Level::Scalar;
+#endif
+}
+
+// Returns the level currently in use.
+ColumnKernels::Level ColumnKernels::level() noexcept
+{
+    return ActiveLevel().load(std::memory_order_relaxed);
+}
+
+// Selects the level in use, limited to supportedLevel().
+void ColumnKernels::setLevel(Level level) noexcept
+{
+    ActiveLevel().store(std::min(level, supportedLevel()), std::memory_order_relaxed);
+}
+
+// Returns a printable name of level.
+const char *ColumnKernels::levelName(Level level) noexcept
+{
+    switch (level)
+    {
+    case Level::AVX2:
+        return "avx2";
+    case Level::SSE2:
+        return "sse2";
+    default:
+        return "scalar";
+    }
+}
+
+// Computes minimum and maximum of values[0..n).
+void ColumnKernels::minMax(const double *values, std::size_t n, double &minValue, double &maxValue) noexcept
+{
+    switch (level())
+    {
+#ifdef COLUMNKERNELS_AVX2
+    case Level::AVX2:
+        return Avx2MinMax(values, n, minValue, maxValue);
+#endif
+#ifdef COLUMNKERNELS_SSE2
+    case Level::SSE2:
+        return Sse2MinMax(values, n, minValue, maxValue);
+#endif
+    default:
+        return ScalarMinMax(values, n, minValue, maxValue);
+    }
+}
+
+// Returns the dot product of a[0..n) and b[0..n).
+double ColumnKernels::dot(const double *a, const double *b, std::size_t n) noexcept
+{
+    switch (level())
+    {
+#ifdef COLUMNKERNELS_AVX2
+    case Level::AVX2:
+        return Avx2Dot(a, b, n);
+#endif
+#ifdef COLUMNKERNELS_SSE2
+    case Level::SSE2:
+        return Sse2Dot(a, b, n);
+#endif
+    default:
+        return ScalarDot(a, b, n);
+    }
+}
+
+// Returns the regression sums over all points k with x[k] >= threshold.
+RegressionSums ColumnKernels::maskedRegressionSums(
+    const double *x, const double *y, std::size_t n, double threshold) noexcept
+{
+    switch (level())
+    {
+#ifdef COLUMNKERNELS_AVX2
+    case Level::AVX2:
+        return Avx2RegressionSums(x, y, n, threshold);
+#endif
+#ifdef COLUMNKERNELS_SSE2
+    case Level::SSE2:
+        return Sse2RegressionSums(x, y, n, threshold);
+#endif
+    default:
+        return ScalarRegressionSums(x, y, n, threshold);
+    }
+}
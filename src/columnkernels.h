@@ -0,0 +1,66 @@
+// ---------------------------------------------------------------------------
+//  Vectorized kernels over measurement sample columns.
+//
+//  Reductions used by the analysis code (min/max, dot products and masked
+//  regression sums) with SSE2 and AVX2 implementations on x86 and
+//  a portable scalar fallback. The best implementation supported by the
+//  CPU is selected at runtime on first use.
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+// Portable core module, no Qt dependencies.
+#include <cstddef>
+
+// ---------------------------------------------------------------------------
+//  RegressionSums:
+//  Sums for a linear least-squares fit y = a * x + b over selected points.
+// ---------------------------------------------------------------------------
+struct RegressionSums
+{
+    std::size_t count = 0;
+    double sumX = 0.0;
+    double sumY = 0.0;
+    double sumXY = 0.0;
+    double sumXX = 0.0;
+};
+
+// ---------------------------------------------------------------------------
+//  ColumnKernels:
+//  Runtime-dispatched column reductions. Inputs need no special alignment;
+//  SampleColumn data is cache line aligned, which the kernels benefit from.
+// ---------------------------------------------------------------------------
+class ColumnKernels
+{
+  public:
+    // Instruction set levels, ordered by capability.
+    enum class Level
+    {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    // Returns the best level supported by this CPU and build.
+    static Level supportedLevel() noexcept;
+
+    // Returns the level currently in use.
+    static Level level() noexcept;
+
+    // Selects the level in use, limited to supportedLevel(). Intended for
+    // benchmarks and comparisons; the default is supportedLevel().
+    static void setLevel(Level level) noexcept;
+
+    // Returns a printable name of level.
+    static const char *levelName(Level level) noexcept;
+
+    // Computes minimum and maximum of values[0..n). For n = 0 the results
+    // are +inf and -inf.
+    static void minMax(const double *values, std::size_t n, double &minValue, double &maxValue) noexcept;
+
+    // Returns the dot product of a[0..n) and b[0..n).
+    static double dot(const double *a, const double *b, std::size_t n) noexcept;
+
+    // Returns the regression sums over all points k with x[k] >= threshold.
+    static RegressionSums maskedRegressionSums(const double *x, const double *y, std::size_t n, double threshold) noexcept;
+};
@@ -9,33 +9,99 @@
 
 // Portable core module, no Qt dependencies.
 #include "coredatatypes.h"
+#include "columnkernels.h"
 
 // Constructs an empty measurement series.
 MeasurementSeries::MeasurementSeries()
 {
-    points_.reserve(InitialPointCapacity);
+    voltages_.reserve(InitialPointCapacity);
+    currents_.reserve(InitialPointCapacity);
+}
+
+// Constructs an empty measurement series with room for capacity points.
+MeasurementSeries::MeasurementSeries(std::size_t capacity)
+{
+    voltages_.reserve(capacity);
+    currents_.reserve(capacity);
 }
 
 // Adds a new measurement point.
 void MeasurementSeries::addPoint(double voltage, double currentMilliAmp)
 {
-    points_.emplace_back(voltage, currentMilliAmp);
+    voltages_.push_back(voltage);
+    currents_.push_back(currentMilliAmp);
+    bounds_.include(voltage, currentMilliAmp);
+}
+
+// Replaces all points with n points from the given columns.
+void MeasurementSeries::assign(const double *voltages, const double *currentsMilliAmp, std::size_t n)
+{
+    voltages_.assign(voltages, voltages + n);
+    currents_.assign(currentsMilliAmp, currentsMilliAmp + n);
+
+    // Bounds in one vectorized pass per column
+    bounds_ = MeasurementBounds{};
+    if (n > 0)
+    {
+        ColumnKernels::minMax(voltages_.data(), n, bounds_.minVoltage, bounds_.maxVoltage);
+        ColumnKernels::minMax(currents_.data(), n, bounds_.minCurrent, bounds_.maxCurrent);
+    }
+}
+
+// Replaces all points with n points from the given single-precision columns.
+void MeasurementSeries::assign(const float *voltages, const float *currentsMilliAmp, std::size_t n)
+{
+    voltages_.assign(voltages, voltages + n);
+    currents_.assign(currentsMilliAmp, currentsMilliAmp + n);
+
+    bounds_ = MeasurementBounds{};
+    if (n > 0)
+    {
+        ColumnKernels::minMax(voltages_.data(), n, bounds_.minVoltage, bounds_.maxVoltage);
+        ColumnKernels::minMax(currents_.data(), n, bounds_.minCurrent, bounds_.maxCurrent);
+    }
+}
+
+// Removes all points, keeping the allocated capacity for reuse.
+void MeasurementSeries::clear() noexcept
+{
+    voltages_.clear();
+    currents_.clear();
+    bounds_ = MeasurementBounds{};
+}
+
+// Returns the measurement point at index i (i < size()).
+MeasurementPoint MeasurementSeries::point(std::size_t i) const noexcept
+{
+    return MeasurementPoint(voltages_[i], currents_[i]);
+}
+
+// Returns the voltage column (V), one entry per point.
+const SampleColumn &MeasurementSeries::voltages() const noexcept
+{
+    return voltages_;
+}
+
+// Returns the current column (mA), one entry per point.
+const SampleColumn &MeasurementSeries::currents() const noexcept
+{
+    return currents_;
 }
 
-// Returns a read-only reference to the measurement points.
-const std::vector<MeasurementPoint> &MeasurementSeries::points() const noexcept
+// Returns the bounds of all points, maintained on insertion.
+const MeasurementBounds &MeasurementSeries::bounds() const noexcept
 {
-    return points_;
+    return bounds_;
 }
 
 // Returns the number of measurement points.
 std::size_t MeasurementSeries::size() const noexcept
 {
-    return points_.size();
+    return voltages_.size();
 }
 
 // Returns true if the series is empty.
 bool MeasurementSeries::empty() const noexcept
 {
-    return points_.empty();
+    return voltages_.empty();
 }
@@ -10,6 +10,9 @@
 #pragma once
 
 // Portable core module, no Qt dependencies.
+#include "samplepool.h"
+#include <algorithm>
+#include <limits>
 #include <vector>
 
 // ---------------------------------------------------------------------------
@@ -29,10 +32,53 @@ struct MeasurementPoint
     }
 };
 
+// ---------------------------------------------------------------------------
+//  MeasurementBounds:
+//  Minimum and maximum voltage (V) and current (mA) of a set of points.
+//  An empty set has inverted (infinite) bounds.
+// ---------------------------------------------------------------------------
+struct MeasurementBounds
+{
+    double minVoltage = std::numeric_limits<double>::infinity();
+    double maxVoltage = -std::numeric_limits<double>::infinity();
+    double minCurrent = std::numeric_limits<double>::infinity();
+    double maxCurrent = -std::numeric_limits<double>::infinity();
+
+    // Extends the bounds to include the given point.
+    void include(double voltage, double current) noexcept
+    {
+        minVoltage = std::min(minVoltage, voltage);
+        maxVoltage = std::max(maxVoltage, voltage);
+        minCurrent = std::min(minCurrent, current);
+        maxCurrent = std::max(maxCurrent, current);
+    }
+
+    // Extends the bounds to include other.
+    void include(const MeasurementBounds &other) noexcept
+    {
+        minVoltage = std::min(minVoltage, other.minVoltage);
+        maxVoltage = std::max(maxVoltage, other.maxVoltage);
+        minCurrent = std::min(minCurrent, other.minCurrent);
+        maxCurrent = std::max(maxCurrent, other.maxCurrent);
+    }
+};
+
+// Alignment of sample columns (bytes): one cache line, also sufficient for
+// aligned loads of the widest SIMD registers in use.
+constexpr std::size_t SampleAlignment = SamplePool::Alignment;
+
+// Contiguous column of samples (e.g. all voltages of a series), stored in
+// pooled blocks shared by all series (see SamplePool).
+using SampleColumn = std::vector<double, SampleAllocator<double>>;
+
 // ---------------------------------------------------------------------------
 //  MeasurementSeries:
 //  A complete set of measurement points forming a single I–V curve. Built
 //  by the parser and later used for visualization, analysis, and export.
+//
+//  Points are stored as separate voltage and current columns (structure
+//  of arrays), so single-column scans touch only the data they need and
+//  compile to vectorized loops.
 // ---------------------------------------------------------------------------
 class MeasurementSeries
 {
@@ -44,11 +90,32 @@ class MeasurementSeries
     // Constructs an empty measurement series.
     MeasurementSeries();
 
+    // Constructs an empty measurement series with room for capacity points.
+    explicit MeasurementSeries(std::size_t capacity);
+
     // Adds a new measurement point.
     void addPoint(double voltage, double currentMilliAmp);
 
-    // Returns a read-only reference to the measurement points.
-    const std::vector<MeasurementPoint> &points() const noexcept;
+    // Replaces all points with n points from the given columns.
+    void assign(const double *voltages, const double *currentsMilliAmp, std::size_t n);
+
+    // Same as above for single-precision columns (e.g. from a session file).
+    void assign(const float *voltages, const float *currentsMilliAmp, std::size_t n);
+
+    // Removes all points, keeping the allocated capacity for reuse.
+    void clear() noexcept;
+
+    // Returns the measurement point at index i (i < size()).
+    MeasurementPoint point(std::size_t i) const noexcept;
+
+    // Returns the voltage column (V), one entry per point.
+    const SampleColumn &voltages() const noexcept;
+
+    // Returns the current column (mA), one entry per point.
+    const SampleColumn &currents() const noexcept;
+
+    // Returns the bounds of all points, maintained on insertion.
+    const MeasurementBounds &bounds() const noexcept;
 
     // Returns the number of measurement points.
     std::size_t size() const noexcept;
@@ -57,6 +124,12 @@ class MeasurementSeries
     bool empty() const noexcept;
 
   private:
-    // Measurement points.
-    std::vector<MeasurementPoint> points_;
+    // Voltages (V) of all points.
+    SampleColumn voltages_;
+
+    // Currents (mA) of all points, same length as voltages_.
+    SampleColumn currents_;
+
+    // Bounds of all points.
+    MeasurementBounds bounds_;
 };
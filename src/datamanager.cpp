@@ -4,18 +4,24 @@
 //  measurement data.
 //
 //  - Maintains a collection of measurement series
+//  - Keeps an undo/redo history of removals and session loads
 //  - Exports data to CSV or Python format
-//  - Generates simulated diode characteristics
-//  - Computes piecewise-linear diode parameters
+//  - Saves and loads binary session files (see SessionWriter)
+//  - Generates simulated diode characteristics (see IVGenerator)
+//  - Computes piecewise-linear and Shockley diode parameters, for all
+//    series in parallel
 // ---------------------------------------------------------------------------
 
 // Portable core module, no Qt dependencies.
 #include "datamanager.h"
+#include "columnkernels.h"
 #include <algorithm>
-#include <array>
 #include <cmath>
 #include <cstdio>
 #include <fstream>
+#include <functional>
+#include <system_error>
+#include <thread>
 
 // Returns the number of stored measurement series.
 std::size_t MeasurementDataManager::seriesCount() const noexcept
@@ -29,91 +35,149 @@ const std::vector<MeasurementSeries> &MeasurementDataManager::allSeries() const
     return series_;
 }
 
-// Removes all stored measurement series.
-void MeasurementDataManager::removeAllSeries()
+// Removes all stored measurement series (undoable). Returns false if
+// there are none.
+bool MeasurementDataManager::removeAllSeries()
 {
-    series_.clear();
+    // An empty step would consume an undo and clear the redo history
+    if (series_.empty())
+        return false;
+
+    applyStep(0, series_.size(), {});
+    return true;
 }
 
-// Removes the most recently added measurement series.
-void MeasurementDataManager::removeLastSeries()
+// Removes the most recently added measurement series (undoable).
+// Returns false if there are none.
+bool MeasurementDataManager::removeLastSeries()
 {
-    if (!series_.empty())
-        series_.pop_back();
+    if (series_.empty())
+        return false;
+
+    applyStep(series_.size() - 1, 1, {});
+    return true;
 }
 
-// Adds a completed measurement series to the collection.
-void MeasurementDataManager::appendSeries(const MeasurementSeries &series)
+// Replaces all stored measurement series with series (undoable),
+// always recording a step.
+void MeasurementDataManager::replaceAllSeries(std::vector<MeasurementSeries> &&series)
 {
-    series_.push_back(series);
+    applyStep(0, series_.size(), std::move(series));
+}
+
+// Returns true if there is a step to undo.
+bool MeasurementDataManager::canUndo() const noexcept
+{
+    return !undoSteps_.empty();
+}
+
+// Returns true if there is an undone step to redo.
+bool MeasurementDataManager::canRedo() const noexcept
+{
+    return !redoSteps_.empty();
+}
+
+// Reverts the most recent removal or session load.
+bool MeasurementDataManager::undo()
+{
+    if (undoSteps_.empty())
+        return false;
+
+    redoSteps_.push_back(std::move(undoSteps_.back()));
+    undoSteps_.pop_back();
+    swapStep(redoSteps_.back(), redoSteps_.back().insertedCount);
+    return true;
 }
 
-// Appends simulated diode I–V characteristics to the collection.
-void MeasurementDataManager::appendSimulatedSeries()
+// Repeats the most recently undone step.
+bool MeasurementDataManager::redo()
 {
-    static constexpr std::array Voltage1 = {0.000000, 0.193000, 0.290000, 0.389000, 0.489000, 0.552000, 0.603000,
-        0.630000, 0.650000, 0.659000, 0.671000, 0.682000, 0.687000, 0.696000, 0.701000, 0.707000, 0.711000, 0.716000,
-        0.720000, 0.724000, 0.727000, 0.730000, 0.734000, 0.734000, 0.739000, 0.739000, 0.744000, 0.744000, 0.745000,
-        0.748000, 0.749000, 0.753000, 0.753000, 0.754000, 0.758000, 0.758000, 0.758000, 0.761000, 0.763000, 0.763000,
-        0.763000, 0.767000, 0.767000, 0.767000, 0.768000, 0.772000, 0.772000, 0.772000, 0.772000, 0.772000};
+    if (redoSteps_.empty())
+        return false;
 
-    static constexpr std::array Current1 = {0.000000, 0.000000, 0.000000, 0.002000, 0.009000, 0.045000, 0.151000,
-        0.294000, 0.468000, 0.595000, 0.777000, 0.969000, 1.104000, 1.301000, 1.506000, 1.693000, 1.863000, 2.027000,
-        2.214000, 2.403000, 2.636000, 2.818000, 2.984000, 3.190000, 3.373000, 3.540000, 3.748000, 3.935000, 4.068000,
-        4.293000, 4.471000, 4.642000, 4.883000, 5.054000, 5.235000, 5.423000, 5.611000, 5.792000, 5.988000, 6.179000,
-        6.365000, 6.581000, 6.740000, 6.937000, 7.137000, 7.328000, 7.505000, 7.711000, 7.768000, 7.768000};
+    undoSteps_.push_back(std::move(redoSteps_.back()));
+    redoSteps_.pop_back();
+    swapStep(undoSteps_.back(), undoSteps_.back().removedCount);
+    return true;
+}
 
-    static constexpr std::array Voltage2 = {0.000000, 0.195000, 0.293000, 0.391000, 0.481000, 0.588000, 0.678000,
-        0.772000, 0.875000, 0.959000, 1.073000, 1.158000, 1.261000, 1.355000, 1.453000, 1.536000, 1.583000, 1.614000,
-        1.640000, 1.656000, 1.670000, 1.684000, 1.691000, 1.701000, 1.712000, 1.717000, 1.726000, 1.734000, 1.740000,
-        1.746000, 1.754000, 1.757000, 1.764000, 1.769000, 1.774000, 1.779000, 1.786000, 1.789000, 1.796000, 1.802000,
-        1.807000, 1.811000, 1.816000, 1.820000, 1.825000, 1.830000, 1.834000, 1.839000, 1.840000, 1.840000};
+// Discards the undo/redo history and releases the series it holds.
+void MeasurementDataManager::clearHistory()
+{
+    undoSteps_.clear();
+    redoSteps_.clear();
+}
 
-    static constexpr std::array Current2 = {0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
-        0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.008000, 0.042000, 0.127000, 0.236000,
-        0.408000, 0.546000, 0.715000, 0.895000, 1.037000, 1.215000, 1.413000, 1.599000, 1.726000, 1.960000, 2.084000,
-        2.267000, 2.495000, 2.626000, 2.799000, 3.022000, 3.203000, 3.371000, 3.572000, 3.718000, 3.902000, 4.108000,
-        4.297000, 4.447000, 4.655000, 4.819000, 5.009000, 5.198000, 5.379000, 5.576000, 5.715000, 5.724000};
+// Adds a completed measurement series to the collection.
+void MeasurementDataManager::appendSeries(const MeasurementSeries &series)
+{
+    storeSeries(MeasurementSeries(series));
+}
 
-    // Helper to add a series
-    auto addSeries = [this](const auto &v, const auto &i)
+// Adds a completed measurement series, taking over its storage.
+void MeasurementDataManager::appendSeries(MeasurementSeries &&series)
+{
+    storeSeries(std::move(series));
+}
+
+// Appends simulated diode I–V characteristics to the collection,
+// alternating between a silicon diode and a red LED.
+void MeasurementDataManager::appendSimulatedSeries(std::size_t count)
+{
+    // Slight device variation and noise, like repeated real measurements
+    auto realistic = [](IVGeneratorSettings s, unsigned seed)
     {
-        if (v.size() != i.size())
-            return; // malformed built-in simulation data
+        s.parameterSpread = 0.05;
+        s.currentNoise = 0.005;
+        s.voltageNoise = 0.001;
+        s.seed = seed;
+        return s;
+    };
 
-        MeasurementSeries s;
-        for (std::size_t idx = 0; idx < v.size(); ++idx)
-            s.addPoint(v[idx], i[idx]);
-        series_.push_back(std::move(s));
+    IVGenerator generators[] = {
+        IVGenerator(realistic(IVGeneratorSettings::SiliconDiode(), 1)),
+        IVGenerator(realistic(IVGeneratorSettings::RedLED(), 2)),
     };
 
-    // Append both series
-    addSeries(Voltage1, Current1);
-    addSeries(Voltage2, Current2);
+    series_.reserve(series_.size() + count);
+    prefixBounds_.reserve(prefixBounds_.size() + count);
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        MeasurementSeries s;
+        generators[k % 2].generate(s);
+        storeSeries(std::move(s));
+    }
 }
 
-// Retrieves the maximum voltage (V) across all series.
-double MeasurementDataManager::maxVoltage() const noexcept
+// Appends count series produced by generator to the collection.
+void MeasurementDataManager::appendGeneratedSeries(IVGenerator &generator, std::size_t count)
 {
-    double maxV = 0.0;
+    series_.reserve(series_.size() + count);
+    prefixBounds_.reserve(prefixBounds_.size() + count);
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        MeasurementSeries s;
+        generator.generate(s);
+        storeSeries(std::move(s));
+    }
+}
 
-    for (const auto &series : series_)
-        for (const auto &p : series.points())
-            maxV = std::max(maxV, p.voltageVolt);
+// Retrieves the bounds across all series in O(1).
+MeasurementBounds MeasurementDataManager::bounds() const noexcept
+{
+    return prefixBounds_.empty() ? MeasurementBounds{} : prefixBounds_.back();
+}
 
-    return maxV;
+// Retrieves the maximum voltage (V) across all series in O(1).
+double MeasurementDataManager::maxVoltage() const noexcept
+{
+    return std::max(0.0, bounds().maxVoltage);
 }
 
-// Retrieves the maximum current (mA) across all series.
+// Retrieves the maximum current (mA) across all series in O(1).
 double MeasurementDataManager::maxCurrent() const noexcept
 {
-    double maxI = 0.0;
-
-    for (const auto &series : series_)
-        for (const auto &p : series.points())
-            maxI = std::max(maxI, p.currentMilliAmp);
-
-    return maxI;
+    return std::max(0.0, bounds().maxCurrent);
 }
 
 // Exports all stored measurement series to a CSV file.
@@ -125,19 +189,21 @@ bool MeasurementDataManager::exportCSV(const std::string &filePath, const CSVSet
         return false;
 
     for (std::size_t i = 0; i < series_.size(); ++i)
-    {
-        const auto &s = series_[i];
-        out << "Series " << (i + 1) << "\n";
-        out << "Volt (V)" << csv.fieldSeparator << "Milliampere (mA)\n";
+        writeSeriesCSV(out, series_[i], i + 1, csv);
 
-        for (const auto &p : s.points())
-        {
-            out << formatDouble(p.voltageVolt, csv.decimalSeparator) << csv.fieldSeparator;
-            out << formatDouble(p.currentMilliAmp, csv.decimalSeparator) << "\n";
-        }
-        out << "\n";
-    }
+    return out.good();
+}
+
+// Appends series, numbered as the given series, to a CSV file written
+// by exportCSV(). Returns true on success.
+bool MeasurementDataManager::appendSeriesCSV(const std::string &filePath, const MeasurementSeries &series,
+    std::size_t number, const CSVSettings &csv) const
+{
+    std::ofstream out(filePath, std::ios::app);
+    if (!out)
+        return false;
 
+    writeSeriesCSV(out, series, number, csv);
     return out.good();
 }
 
@@ -154,6 +220,19 @@ bool MeasurementDataManager::exportPython(const std::string &filePath) const
     out << "import matplotlib.pyplot as plt\n\n";
     out << "series = []\n\n";
 
+    // Writes a column as Python list
+    auto writeList = [&](const SampleColumn &column)
+    {
+        out << "[";
+        for (std::size_t j = 0; j < column.size(); ++j)
+        {
+            out << formatDouble(column[j], '.'); // Python expects dot
+            if (j + 1 < column.size())
+                out << ", ";
+        }
+        out << "]\n";
+    };
+
     for (std::size_t i = 0; i < series_.size(); ++i)
     {
         const auto &s = series_[i];
@@ -161,26 +240,12 @@ bool MeasurementDataManager::exportPython(const std::string &filePath) const
         out << "# Series " << idx << "\n";
 
         // Voltage list
-        out << "voltage_" << idx << " = [";
-        for (std::size_t j = 0; j < s.points().size(); ++j)
-        {
-            const auto &p = s.points()[j];
-            out << formatDouble(p.voltageVolt, '.'); // Python expects dot
-            if (j + 1 < s.points().size())
-                out << ", ";
-        }
-        out << "]\n";
+        out << "voltage_" << idx << " = ";
+        writeList(s.voltages());
 
         // Current list
-        out << "current_" << idx << " = [";
-        for (std::size_t j = 0; j < s.points().size(); ++j)
-        {
-            const auto &p = s.points()[j];
-            out << formatDouble(p.currentMilliAmp, '.'); // Python expects dot
-            if (j + 1 < s.points().size())
-                out << ", ";
-        }
-        out << "]\n";
+        out << "current_" << idx << " = ";
+        writeList(s.currents());
         out << "series.append((voltage_" << idx << ", current_" << idx << "))\n\n";
     }
 
@@ -198,6 +263,43 @@ bool MeasurementDataManager::exportPython(const std::string &filePath) const
     return out.good();
 }
 
+// Saves all stored measurement series to a binary session file.
+// Returns true on success.
+bool MeasurementDataManager::saveSession(const std::string &filePath, const SessionMetadata &metadata) const
+{
+    SessionWriter writer;
+    if (!writer.create(filePath, metadata))
+        return false;
+
+    for (const auto &series : series_)
+    {
+        if (!writer.append(series))
+            return false;
+    }
+
+    return writer.close();
+}
+
+// Replaces all stored measurement series with those of a binary session
+// file. Leaves the collection unchanged on failure.
+bool MeasurementDataManager::loadSession(const std::string &filePath)
+{
+    SessionReader reader;
+    if (!reader.open(filePath))
+        return false;
+
+    // Decode everything first, the stored series are kept on failure
+    std::vector<MeasurementSeries> loaded(reader.seriesCount());
+    for (std::size_t i = 0; i < loaded.size(); ++i)
+    {
+        if (!reader.readSeries(i, loaded[i]))
+            return false;
+    }
+
+    replaceAllSeries(std::move(loaded));
+    return true;
+}
+
 // Computes piecewise-linear diode parameters (Vf, Rs).
 // Returns true on success.
 bool MeasurementDataManager::computePWL(double &forwardV, double &seriesR) const
@@ -206,47 +308,195 @@ bool MeasurementDataManager::computePWL(double &forwardV, double &seriesR) const
     if (series_.size() != 1)
         return false;
 
+    return fitPWL(series_[0], forwardV, seriesR);
+}
+
+// Computes piecewise-linear diode parameters for every stored series
+// on threadCount threads (0 = one per hardware thread).
+std::vector<PWLModel> MeasurementDataManager::computeAllPWL(unsigned threadCount) const
+{
+    std::vector<PWLModel> models(series_.size());
+    forEachSeriesBlock(threadCount, MinPWLSeriesPerThread,
+        [this, &models](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+                models[i].valid = fitPWL(series_[i], models[i].forwardV, models[i].seriesR);
+        });
+
+    return models;
+}
+
+// Fits Shockley diode models (Is, n, Rs) at the given temperature (K)
+// to every stored series on threadCount threads.
+std::vector<ShockleyFit> MeasurementDataManager::computeAllShockley(double temperature, unsigned threadCount) const
+{
+    std::vector<ShockleyFit> fits(series_.size());
+    forEachSeriesBlock(threadCount, MinShockleySeriesPerThread,
+        [this, &fits, temperature](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                fits[i].model.temperature = temperature;
+                FitShockleyModel(series_[i], fits[i]);
+            }
+        });
+
+    return fits;
+}
+
+// Calls processRange(begin, end) for contiguous blocks of series indices,
+// distributed over up to threadCount threads (0 = one per hardware thread)
+// with at least minPerThread series each.
+template <typename RangeFunction>
+void MeasurementDataManager::forEachSeriesBlock(
+    unsigned threadCount, std::size_t minPerThread, const RangeFunction &processRange) const
+{
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    const std::size_t n = series_.size();
+    const std::size_t threads = std::min<std::size_t>(threadCount, (n + minPerThread - 1) / minPerThread);
+    if (threads <= 1)
+    {
+        processRange(std::size_t{0}, n);
+        return;
+    }
+
+    // The calling thread takes the first block
+    const std::size_t block = (n + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+
+    for (std::size_t t = 1; t < threads; ++t)
+    {
+        const std::size_t begin = std::min(n, t * block);
+        const std::size_t end = std::min(n, begin + block);
+        try
+        {
+            workers.emplace_back(std::cref(processRange), begin, end);
+        }
+        catch (const std::system_error &)
+        {
+            processRange(begin, end); // no thread available, process inline
+        }
+    }
+
+    processRange(std::size_t{0}, std::min(n, block));
+    for (auto &w : workers)
+        w.join();
+}
+
+// Fits the piecewise-linear model of a single series.
+bool MeasurementDataManager::fitPWL(const MeasurementSeries &series, double &forwardV, double &seriesR) noexcept
+{
     // Ignore measurement points below 0.5 * maxI (non-conducting diode)
-    const double noiseFloor = 0.1; // mA
-    const double threshold = std::max(0.5 * maxCurrent(), noiseFloor);
+    const double threshold = std::max(PWLThresholdRatio * series.bounds().maxCurrent, PWLNoiseFloor);
 
     // Linear least-squares fit: V = Rs * I + Vf where
     // Rs = Effective series resistance, Vf = Forward voltage (turn-on)
-    int n = 0;
-    double sumI = 0.0;
-    double sumV = 0.0;
-    double sumIV = 0.0;
-    double sumII = 0.0;
+    const RegressionSums r = ColumnKernels::maskedRegressionSums(
+        series.currents().data(), series.voltages().data(), series.size(), threshold);
 
-    for (const auto &p : series_[0].points())
+    return SolvePWL(r, forwardV, seriesR);
+}
+
+// Replaces count series at position with the series in 'in' and moves
+// the replaced series into 'out'.
+void MeasurementDataManager::spliceSeries(std::size_t position, std::size_t count,
+    std::vector<MeasurementSeries> &in, std::vector<MeasurementSeries> &out)
+{
+    position = std::min(position, series_.size());
+    count = std::min(count, series_.size() - position);
+
+    out.clear();
+    if (count == series_.size())
+    {
+        // Whole collection, e.g. remove all: O(1)
+        out.swap(series_);
+        series_.swap(in);
+    }
+    else
     {
-        if (p.currentMilliAmp < threshold)
-            continue;
-
-        const double I = p.currentMilliAmp * 1e-3; // convert mA to A
-        sumI += I;
-        sumV += p.voltageVolt;
-        sumIV += I * p.voltageVolt;
-        sumII += I * I;
-        ++n;
+        const auto first = series_.begin() + static_cast<std::ptrdiff_t>(position);
+        const auto last = first + static_cast<std::ptrdiff_t>(count);
+        out.assign(std::make_move_iterator(first), std::make_move_iterator(last));
+        series_.erase(first, last);
+        series_.insert(series_.begin() + static_cast<std::ptrdiff_t>(position), std::make_move_iterator(in.begin()),
+            std::make_move_iterator(in.end()));
     }
+    in.clear();
 
-    // Guard against invalid or ill-conditioned regression:
-    // requires n >= 2 and non-zero variance in current (denom)
-    const double denom = (n * sumII - sumI * sumI);
-    if (n < 2 || denom < 1e-15)
-        return false;
+    // Bounds before position are unaffected
+    prefixBounds_.resize(series_.size());
+    MeasurementBounds b = position > 0 ? prefixBounds_[position - 1] : MeasurementBounds{};
+    for (std::size_t i = position; i < series_.size(); ++i)
+    {
+        b.include(series_[i].bounds());
+        prefixBounds_[i] = b;
+    }
+}
 
-    seriesR = (n * sumIV - sumI * sumV) / denom;
-    forwardV = (sumV - seriesR * sumI) / n;
+// Applies an edit as new undoable step and clears the redo history.
+void MeasurementDataManager::applyStep(std::size_t position, std::size_t removeCount,
+    std::vector<MeasurementSeries> &&insert)
+{
+    HistoryStep step;
+    step.position = position;
+    step.insertedCount = insert.size();
+    spliceSeries(position, removeCount, insert, step.stash);
+    step.removedCount = step.stash.size();
+
+    // Series stashed by dropped steps are released
+    bool released = false;
+    for (const HistoryStep &dropped : redoSteps_)
+        released = released || !dropped.stash.empty();
+    redoSteps_.clear();
+
+    undoSteps_.push_back(std::move(step));
+    if (undoSteps_.size() > MaxHistorySteps)
+    {
+        released = released || !undoSteps_.front().stash.empty();
+        undoSteps_.pop_front();
+    }
 
-    // Sanity checks
-    if (!std::isfinite(seriesR) || !std::isfinite(forwardV))
-        return false;
-    if (seriesR <= 0.0 || forwardV <= 0.0)
-        return false;
+    // Return pool chunks emptied by them to the heap
+    if (released)
+        SamplePool::releaseUnused();
+}
 
-    return true;
+// Swaps the series of step with the outCount series at its position;
+// outCount receives the number actually swapped out.
+void MeasurementDataManager::swapStep(HistoryStep &step, std::size_t &outCount)
+{
+    std::vector<MeasurementSeries> out;
+    spliceSeries(step.position, outCount, step.stash, out);
+    outCount = out.size();
+    step.stash = std::move(out);
+}
+
+// Appends a series and updates the cached bounds.
+void MeasurementDataManager::storeSeries(MeasurementSeries &&series)
+{
+    MeasurementBounds b = bounds();
+    b.include(series.bounds());
+
+    series_.push_back(std::move(series));
+    prefixBounds_.push_back(b);
+}
+
+// Writes series as CSV block of the given series number.
+void MeasurementDataManager::writeSeriesCSV(std::ostream &out, const MeasurementSeries &s, std::size_t number,
+    const CSVSettings &csv) const
+{
+    out << "Series " << number << "\n";
+    out << "Volt (V)" << csv.fieldSeparator << "Milliampere (mA)\n";
+
+    for (std::size_t k = 0; k < s.size(); ++k)
+    {
+        out << formatDouble(s.voltages()[k], csv.decimalSeparator) << csv.fieldSeparator;
+        out << formatDouble(s.currents()[k], csv.decimalSeparator) << "\n";
+    }
+    out << "\n";
 }
 
 // Converts a double to a string and replaces the decimal separator.
@@ -4,16 +4,25 @@
 //  measurement data.
 //
 //  - Maintains a collection of measurement series
+//  - Keeps an undo/redo history of removals and session loads
 //  - Exports data to CSV or Python format
-//  - Generates simulated diode characteristics
-//  - Computes piecewise-linear diode parameters
+//  - Saves and loads binary session files (see SessionWriter)
+//  - Generates simulated diode characteristics (see IVGenerator)
+//  - Computes piecewise-linear and Shockley diode parameters, for all
+//    series in parallel
 // ---------------------------------------------------------------------------
 
 #pragma once
 
 // Portable core module, no Qt dependencies.
 #include "coredatatypes.h"
+#include "diodefit.h"
+#include "ivgenerator.h"
+#include "pwlfitter.h"
+#include "sessionfile.h"
 #include <cstddef>
+#include <deque>
+#include <iosfwd>
 #include <string>
 #include <vector>
 
@@ -40,6 +49,20 @@ struct CSVSettings
 // ---------------------------------------------------------------------------
 class MeasurementDataManager
 {
+  private:
+    // Minimum number of series per thread in computeAllPWL(), smaller
+    // batches do not pay off the thread start-up cost.
+    static constexpr std::size_t MinPWLSeriesPerThread = 256;
+
+    // Minimum number of series per thread in computeAllShockley(). A
+    // Shockley fit iterates over the series many times, so a few series
+    // already outweigh starting a thread.
+    static constexpr std::size_t MinShockleySeriesPerThread = 4;
+
+    // Number of undoable steps kept; older steps (and the series they
+    // removed) are released.
+    static constexpr std::size_t MaxHistorySteps = 32;
+
   public:
     // Returns the number of stored measurement series.
     std::size_t seriesCount() const noexcept;
@@ -47,40 +70,156 @@ class MeasurementDataManager
     // Returns a read-only reference to all stored measurement series.
     const std::vector<MeasurementSeries> &allSeries() const noexcept;
 
-    // Removes all stored measurement series.
-    void removeAllSeries();
+    // Removes all stored measurement series (undoable). Returns false,
+    // without recording a step, if there are none.
+    bool removeAllSeries();
+
+    // Removes the most recently added measurement series (undoable).
+    // Returns false, without recording a step, if there are none.
+    bool removeLastSeries();
+
+    // Replaces all stored measurement series with series (undoable).
+    // Unlike removeAllSeries(), always records a step, also on an empty
+    // collection.
+    void replaceAllSeries(std::vector<MeasurementSeries> &&series);
+
+    // Returns true if there is a step to undo.
+    bool canUndo() const noexcept;
 
-    // Removes the most recently added measurement series.
-    void removeLastSeries();
+    // Returns true if there is an undone step to redo.
+    bool canRedo() const noexcept;
+
+    // Reverts the most recent removal or session load. Series appended
+    // since then are kept. Returns false if there is nothing to undo.
+    bool undo();
+
+    // Repeats the most recently undone step. Returns false if there is
+    // nothing to redo.
+    bool redo();
+
+    // Discards the undo/redo history and releases the series it holds.
+    void clearHistory();
 
     // Adds a completed measurement series to the collection.
     void appendSeries(const MeasurementSeries &series);
 
-    // Appends simulated diode I–V characteristics to the collection.
-    void appendSimulatedSeries();
+    // Same as above, takes over the storage of series without copying.
+    void appendSeries(MeasurementSeries &&series);
+
+    // Appends simulated diode I–V characteristics to the collection,
+    // alternating between a silicon diode and a red LED.
+    void appendSimulatedSeries(std::size_t count = 2);
+
+    // Appends count series produced by generator to the collection.
+    void appendGeneratedSeries(IVGenerator &generator, std::size_t count);
+
+    // Retrieves the bounds across all series in O(1).
+    MeasurementBounds bounds() const noexcept;
 
-    // Retrieves the maximum voltage (V) across all series.
+    // Retrieves the maximum voltage (V) across all series in O(1).
     double maxVoltage() const noexcept;
 
-    // Retrieves the maximum current (mA) across all series.
+    // Retrieves the maximum current (mA) across all series in O(1).
     double maxCurrent() const noexcept;
 
     // Exports all stored measurement series to a CSV file.
     // Returns true on success.
     bool exportCSV(const std::string &filePath, const CSVSettings &csv) const;
 
+    // Appends series, numbered as the given (1-based) series, to a CSV
+    // file written by exportCSV(). The series need not be stored, so long
+    // acquisitions can be streamed to disk. Returns true on success.
+    bool appendSeriesCSV(const std::string &filePath, const MeasurementSeries &series, std::size_t number,
+        const CSVSettings &csv) const;
+
     // Exports all stored measurement series to a Python script.
     // Returns true on success.
     bool exportPython(const std::string &filePath) const;
 
+    // Saves all stored measurement series to a binary session file.
+    // Returns true on success.
+    bool saveSession(const std::string &filePath, const SessionMetadata &metadata = {}) const;
+
+    // Replaces all stored measurement series with those of a binary
+    // session file (undoable). Leaves the collection unchanged on failure.
+    // Returns true on success.
+    bool loadSession(const std::string &filePath);
+
     // Computes piecewise-linear diode parameters (Vf, Rs).
     // Returns true on success.
     bool computePWL(double &forwardV, double &seriesR) const;
 
+    // Computes piecewise-linear diode parameters for every stored series
+    // on threadCount threads (0 = one per hardware thread). Returns one
+    // model per series, in series order.
+    std::vector<PWLModel> computeAllPWL(unsigned threadCount = 0) const;
+
+    // Fits Shockley diode models (Is, n, Rs) at the given temperature (K)
+    // to every stored series on threadCount threads (0 = one per hardware
+    // thread). Returns one fit per series, in series order.
+    std::vector<ShockleyFit> computeAllShockley(
+        double temperature = DiodeModel::RoomTemperature, unsigned threadCount = 0) const;
+
   private:
+    // ---------------------------------------------------------------------
+    //  HistoryStep:
+    //  An undoable edit that replaced removedCount series at position with
+    //  insertedCount others. The series currently out of the collection
+    //  (removed ones while done, inserted ones while undone) are moved into
+    //  stash, so a step never copies sample data.
+    // ---------------------------------------------------------------------
+    struct HistoryStep
+    {
+        std::size_t position = 0;
+        std::size_t removedCount = 0;
+        std::size_t insertedCount = 0;
+        std::vector<MeasurementSeries> stash;
+    };
+
     // Collection of all acquired measurement series.
     std::vector<MeasurementSeries> series_;
 
+    // Running bounds, prefixBounds_[i] covers series_[0..i]. Appends and
+    // removals at the end are O(1); undo/redo rebuilds from the first
+    // changed series.
+    std::vector<MeasurementBounds> prefixBounds_;
+
+    // Undoable steps (oldest first) and undone steps (most recent last).
+    std::deque<HistoryStep> undoSteps_;
+    std::vector<HistoryStep> redoSteps_;
+
+    // Replaces count series at position with the series in 'in' (moved
+    // from) and moves the replaced series into 'out'. Both ranges are
+    // clamped to the collection.
+    void spliceSeries(std::size_t position, std::size_t count, std::vector<MeasurementSeries> &in,
+        std::vector<MeasurementSeries> &out);
+
+    // Applies an edit as new undoable step and clears the redo history.
+    void applyStep(std::size_t position, std::size_t removeCount, std::vector<MeasurementSeries> &&insert);
+
+    // Swaps the series of step with the outCount series at its position;
+    // outCount receives the number actually swapped out.
+    void swapStep(HistoryStep &step, std::size_t &outCount);
+
+    // Calls processRange(begin, end) for contiguous blocks of series
+    // indices, distributed over up to threadCount threads (0 = one per
+    // hardware thread) with at least minPerThread series each. Returns
+    // when all blocks are processed.
+    template <typename RangeFunction>
+    void forEachSeriesBlock(
+        unsigned threadCount, std::size_t minPerThread, const RangeFunction &processRange) const;
+
+    // Fits the piecewise-linear model of a single series.
+    // Returns true on success.
+    static bool fitPWL(const MeasurementSeries &series, double &forwardV, double &seriesR) noexcept;
+
+    // Appends a series and updates the cached bounds.
+    void storeSeries(MeasurementSeries &&series);
+
+    // Writes series as CSV block of the given (1-based) series number.
+    void writeSeriesCSV(std::ostream &out, const MeasurementSeries &series, std::size_t number,
+        const CSVSettings &csv) const;
+
     // Converts a double to a string and replaces the decimal separator.
     std::string formatDouble(double d, char decimalSeparator) const;
 };
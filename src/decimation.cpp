@@ -0,0 +1,121 @@
+// ---------------------------------------------------------------------------
+//  Level-of-detail decimation of measurement series for display.
+//
+//  Triangle areas are computed in coordinates normalized to the view, so
+//  the selection matches what is visible regardless of the very different
+//  voltage (V) and current (mA) scales.
+// ---------------------------------------------------------------------------
+
+// Portable core module, no Qt dependencies.
+#include "decimation.h"
+#include <algorithm>
+#include <cmath>
+
+// Returns true if point k of series lies inside view.
+static bool InView(const MeasurementSeries &series, std::size_t k, const MeasurementBounds &view) noexcept
+{
+    const double v = series.voltages()[k];
+    const double i = series.currents()[k];
+    return v >= view.minVoltage && v <= view.maxVoltage && i >= view.minCurrent && i <= view.maxCurrent;
+}
+
+// Returns 1 / extent, or 1 for empty or unbounded extents.
+static double InverseExtent(double minValue, double maxValue) noexcept
+{
+    const double extent = maxValue - minValue;
+    return (extent > 0.0 && std::isfinite(extent)) ? 1.0 / extent : 1.0;
+}
+
+// Selects at most maxPoints indices of series points that represent the
+// part of the curve inside view, in ascending order.
+void DecimateSeries(const MeasurementSeries &series, const MeasurementBounds &view, std::size_t maxPoints,
+    std::vector<std::size_t> &indices)
+{
+    indices.clear();
+    const std::size_t n = series.size();
+    if (n == 0)
+        return;
+
+    // Visible range, extended by one point on each side
+    std::size_t first = 0;
+    while (first < n && !InView(series, first, view))
+        ++first;
+
+    std::size_t last = n - 1;
+    if (first == n)
+    {
+        first = 0; // nothing visible, segments may still cross the view
+    }
+    else
+    {
+        while (!InView(series, last, view))
+            --last;
+        first = first > 0 ? first - 1 : 0;
+        last = std::min(last + 1, n - 1);
+    }
+
+    const std::size_t count = last - first + 1;
+    maxPoints = std::max<std::size_t>(maxPoints, 3);
+    if (count <= maxPoints)
+    {
+        indices.reserve(count);
+        for (std::size_t k = first; k <= last; ++k)
+            indices.push_back(k);
+        return;
+    }
+
+    const double *v = series.voltages().data();
+    const double *i = series.currents().data();
+    const double sx = InverseExtent(view.minVoltage, view.maxVoltage);
+    const double sy = InverseExtent(view.minCurrent, view.maxCurrent);
+
+    // First and last point are always kept, the others are bucketed
+    const std::size_t bucketCount = maxPoints - 2;
+    const double bucketSize = static_cast<double>(count - 2) / static_cast<double>(bucketCount);
+    auto bucketStart = [&](std::size_t b)
+    {
+        return first + 1 + static_cast<std::size_t>(static_cast<double>(b) * bucketSize);
+    };
+
+    indices.reserve(maxPoints);
+    indices.push_back(first);
+    std::size_t a = first;
+
+    for (std::size_t b = 0; b < bucketCount; ++b)
+    {
+        const std::size_t begin = bucketStart(b);
+        const std::size_t end = std::min(bucketStart(b + 1), last);
+
+        // Third triangle vertex: average of the next bucket (or the last point)
+        double cx = 0.0;
+        double cy = 0.0;
+        const std::size_t nextEnd = b + 1 < bucketCount ? std::min(bucketStart(b + 2), last) : last + 1;
+        for (std::size_t k = end; k < nextEnd; ++k)
+        {
+            cx += v[k];
+            cy += i[k];
+        }
+        const double nextCount = static_cast<double>(nextEnd - end);
+        cx = cx / nextCount * sx;
+        cy = cy / nextCount * sy;
+
+        const double ax = v[a] * sx;
+        const double ay = i[a] * sy;
+        std::size_t selected = begin;
+        double maxArea = -1.0;
+        for (std::size_t k = begin; k < end; ++k)
+        {
+            const double area = std::abs((ax - cx) * (i[k] * sy - ay) - (ax - v[k] * sx) * (cy - ay));
+            if (area > maxArea)
+            {
+                maxArea = area;
+                selected = k;
+            }
+        }
+
+        indices.push_back(selected);
+        a = selected;
+    }
+
+    indices.push_back(last);
+}
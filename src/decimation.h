@@ -0,0 +1,30 @@
+// ---------------------------------------------------------------------------
+//  Level-of-detail decimation of measurement series for display.
+//
+//  A chart cannot show more than about one point per pixel column, so
+//  dense series are reduced to the points that shape the visible curve
+//  before they are drawn. DecimateSeries() uses the Largest-Triangle-
+//  Three-Buckets algorithm (LTTB): the points are split into equally
+//  sized buckets in acquisition order, and from every bucket the point
+//  spanning the largest triangle with its neighbours is kept. Buckets
+//  follow the point order rather than the voltage axis, so the steep
+//  conducting part of an I–V curve, where many points share almost the
+//  same voltage, keeps its detail.
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+// Portable core module, no Qt dependencies.
+#include "coredatatypes.h"
+#include <cstddef>
+#include <vector>
+
+// Selects at most maxPoints (at least 3) indices of series points that
+// represent the part of the curve inside view (in V and mA), in
+// ascending order. The selection covers all points from the one before
+// the first visible point to the one after the last visible point, so
+// lines extend to the edges of the view; if no point is visible, the
+// whole series is covered. Series with few enough points are returned
+// completely. Runs in O(n).
+void DecimateSeries(const MeasurementSeries &series, const MeasurementBounds &view, std::size_t maxPoints,
+    std::vector<std::size_t> &indices);
@@ -0,0 +1,230 @@
+// ---------------------------------------------------------------------------
+//  Nonlinear Shockley diode model fit.
+//
+//  Fits saturation current Is, ideality factor n and series resistance Rs
+//  of a DiodeModel to a measured I–V curve with a Levenberg–Marquardt
+//  solver. The residuals use the explicit form
+//
+//      V(I) = n * Vt * ln(I / Is + 1) + I * Rs
+//
+//  with analytic Jacobians; Is is estimated as ln(Is) to keep the problem
+//  well scaled. The start values come from a linear least-squares fit of
+//  V = A * ln(I) + B + C * I, so the solver usually converges in a few
+//  iterations. The fitted model evaluates I(V) in closed form via the
+//  Lambert W function (DiodeModel::current()), e.g. for plotting.
+//
+//  A fit performs no heap allocations, so it is cheap enough to run for
+//  every completed series and for large batches.
+// ---------------------------------------------------------------------------
+
+// Portable core module, no Qt dependencies.
+#include "diodefit.h"
+#include <algorithm>
+#include <cmath>
+
+// Lowest current used by the fit (mA), a few steps of the device resolution.
+static constexpr double FitCurrentFloor = 0.02;
+
+// Iteration limit of the Levenberg–Marquardt solver.
+static constexpr int MaxIterations = 50;
+
+// ---------------------------------------------------------------------------
+//  NormalEquations:
+//  Accumulated least-squares system J^T J * d = J^T r of three parameters.
+// ---------------------------------------------------------------------------
+struct NormalEquations
+{
+    double jtj[3][3] = {};
+    double jtr[3] = {};
+    double cost = 0.0; // sum of squared residuals
+    int count = 0;     // number of points used
+
+    // Adds a residual r with Jacobian row j.
+    void add(const double j[3], double r) noexcept
+    {
+        for (int a = 0; a < 3; ++a)
+        {
+            for (int b = 0; b <= a; ++b)
+                jtj[a][b] += j[a] * j[b];
+            jtr[a] += j[a] * r;
+        }
+        cost += r * r;
+        ++count;
+    }
+};
+
+// ---------------------------------------------------------------------------
+//  Solves the symmetric 3x3 system m * x = rhs (lower triangle of m is
+//  used) by Cholesky decomposition. Returns false if m is not positive
+//  definite.
+// ---------------------------------------------------------------------------
+static bool SolveSymmetric3x3(const double m[3][3], const double rhs[3], double x[3]) noexcept
+{
+    double l[3][3] = {};
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int j = 0; j <= i; ++j)
+        {
+            double s = m[i][j];
+            for (int k = 0; k < j; ++k)
+                s -= l[i][k] * l[j][k];
+
+            if (i == j)
+            {
+                if (!(s > 0.0))
+                    return false;
+                l[i][i] = std::sqrt(s);
+            }
+            else
+            {
+                l[i][j] = s / l[j][j];
+            }
+        }
+    }
+
+    // Forward and back substitution
+    double y[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        double s = rhs[i];
+        for (int k = 0; k < i; ++k)
+            s -= l[i][k] * y[k];
+        y[i] = s / l[i][i];
+    }
+    for (int i = 2; i >= 0; --i)
+    {
+        double s = y[i];
+        for (int k = i + 1; k < 3; ++k)
+            s -= l[k][i] * x[k];
+        x[i] = s / l[i][i];
+    }
+
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+//  Start values from the linear model V = A * ln(I) + B + C * I, which
+//  equals the Shockley equation for I >> Is with A = n * Vt,
+//  B = -n * Vt * ln(Is) and C = Rs. Fills p = {ln(Is), n, Rs (kOhm)}.
+// ---------------------------------------------------------------------------
+static bool EstimateStartValues(const double *v, const double *i, std::size_t size, double floor, double vt,
+    double p[3]) noexcept
+{
+    NormalEquations eq;
+    for (std::size_t k = 0; k < size; ++k)
+    {
+        if (!(i[k] >= floor))
+            continue;
+        const double j[3] = {std::log(i[k]), 1.0, i[k]};
+        eq.add(j, v[k]);
+    }
+
+    double abc[3];
+    if (eq.count < 4 || !SolveSymmetric3x3(eq.jtj, eq.jtr, abc) || !(abc[0] > 0.0))
+        return false;
+
+    p[0] = -abc[1] / abc[0];
+    p[1] = abc[0] / vt;
+    p[2] = std::max(abc[2], 0.0);
+    return std::isfinite(p[0]) && std::isfinite(p[1]);
+}
+
+// ---------------------------------------------------------------------------
+//  Accumulates residuals and Jacobian of the Shockley model with
+//  p = {ln(Is), n, Rs (kOhm)} over all points above floor.
+// ---------------------------------------------------------------------------
+static void AccumulateShockley(const double *v, const double *i, std::size_t size, double floor, double vt,
+    const double p[3], NormalEquations &eq) noexcept
+{
+    eq = NormalEquations{};
+    const double is = std::exp(p[0]);
+    const double nVt = p[1] * vt;
+
+    for (std::size_t k = 0; k < size; ++k)
+    {
+        if (!(i[k] >= floor))
+            continue;
+
+        const double log = std::log1p(i[k] / is);
+        const double r = v[k] - (nVt * log + i[k] * p[2]);
+
+        // Partial derivatives of V(I) by ln(Is), n and Rs
+        const double j[3] = {-nVt * i[k] / (i[k] + is), vt * log, i[k]};
+        eq.add(j, r);
+    }
+}
+
+// Fits a Shockley diode model to series.
+bool FitShockleyModel(const MeasurementSeries &series, ShockleyFit &fit) noexcept
+{
+    fit.valid = false;
+    fit.iterations = 0;
+
+    const double *v = series.voltages().data();
+    const double *i = series.currents().data();
+    const std::size_t size = series.size();
+    const double vt = fit.model.thermalVoltage();
+    const double floor = std::max(FitCurrentFloor, 0.002 * series.bounds().maxCurrent);
+
+    // p = {ln(Is), n, Rs}, Rs in kOhm so that I (mA) * Rs is in V
+    double p[3];
+    if (!EstimateStartValues(v, i, size, floor, vt, p))
+        return false;
+
+    NormalEquations eq;
+    AccumulateShockley(v, i, size, floor, vt, p, eq);
+
+    double lambda = 1e-3;
+    for (int iteration = 1; iteration <= MaxIterations; ++iteration)
+    {
+        fit.iterations = iteration;
+
+        // Damped normal equations (Marquardt scaling of the diagonal)
+        double damped[3][3];
+        for (int a = 0; a < 3; ++a)
+            for (int b = 0; b <= a; ++b)
+                damped[a][b] = eq.jtj[a][b] * (a == b ? 1.0 + lambda : 1.0);
+
+        double step[3];
+        if (!SolveSymmetric3x3(damped, eq.jtr, step))
+        {
+            lambda *= 10.0;
+            continue;
+        }
+
+        const double candidate[3] = {p[0] + step[0], p[1] + step[1], p[2] + step[2]};
+        NormalEquations trial;
+        if (candidate[1] > 0.0)
+            AccumulateShockley(v, i, size, floor, vt, candidate, trial);
+
+        if (candidate[1] > 0.0 && trial.cost <= eq.cost)
+        {
+            // Accepted, move towards Gauss–Newton
+            const double decrease = eq.cost - trial.cost;
+            std::copy(candidate, candidate + 3, p);
+            eq = trial;
+            lambda = std::max(lambda * 0.1, 1e-12);
+
+            const bool smallStep = std::fabs(step[0]) < 1e-9 && std::fabs(step[1]) < 1e-9 * p[1] &&
+                                   std::fabs(step[2]) < 1e-9 * std::max(p[2], 1e-3);
+            if (smallStep || decrease <= 1e-10 * eq.cost)
+                break;
+        }
+        else
+        {
+            // Rejected, move towards gradient descent
+            lambda *= 10.0;
+            if (lambda > 1e12)
+                break;
+        }
+    }
+
+    fit.model.saturationCurrent = std::exp(p[0]);
+    fit.model.idealityFactor = p[1];
+    fit.model.seriesResistance = p[2] * 1e3;
+    fit.rmsError = std::sqrt(eq.cost / eq.count);
+    fit.valid = std::isfinite(fit.model.saturationCurrent) && fit.model.saturationCurrent > 0.0 &&
+                std::isfinite(p[1]) && p[1] > 0.0 && std::isfinite(p[2]) && p[2] >= 0.0 &&
+                std::isfinite(fit.rmsError);
+    return fit.valid;
+}
@@ -0,0 +1,43 @@
+// ---------------------------------------------------------------------------
+//  Nonlinear Shockley diode model fit.
+//
+//  Fits saturation current Is, ideality factor n and series resistance Rs
+//  of a DiodeModel to a measured I–V curve with a Levenberg–Marquardt
+//  solver. The residuals use the explicit form
+//
+//      V(I) = n * Vt * ln(I / Is + 1) + I * Rs
+//
+//  with analytic Jacobians; Is is estimated as ln(Is) to keep the problem
+//  well scaled. The start values come from a linear least-squares fit of
+//  V = A * ln(I) + B + C * I, so the solver usually converges in a few
+//  iterations. The fitted model evaluates I(V) in closed form via the
+//  Lambert W function (DiodeModel::current()), e.g. for plotting.
+//
+//  A fit performs no heap allocations, so it is cheap enough to run for
+//  every completed series and for large batches.
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+// Portable core module, no Qt dependencies.
+#include "coredatatypes.h"
+#include "diodemodel.h"
+
+// ---------------------------------------------------------------------------
+//  ShockleyFit:
+//  Result of a Shockley model fit of a single measurement series.
+// ---------------------------------------------------------------------------
+struct ShockleyFit
+{
+    DiodeModel model;      // fitted Is, n and Rs at model.temperature
+    double rmsError = 0.0; // RMS voltage residual (V)
+    int iterations = 0;    // Levenberg–Marquardt iterations performed
+    bool valid = false;    // false if the series could not be fitted
+};
+
+// Fits a Shockley diode model to series. fit.model.temperature must hold
+// the diode temperature (K) on entry; all other fields are outputs.
+// Only points with a measurable forward current are used. Fits with a
+// negative series resistance (e.g. very noisy data) are not valid.
+// Returns true on success (same as fit.valid).
+bool FitShockleyModel(const MeasurementSeries &series, ShockleyFit &fit) noexcept;
@@ -0,0 +1,77 @@
+// ---------------------------------------------------------------------------
+//  Shockley diode model with series resistance.
+//
+//  Describes the static I–V characteristic of a junction diode,
+//
+//      I = Is * (exp((V - I * Rs) / (n * Vt)) - 1),   Vt = k * T / q
+//
+//  and evaluates it in both directions. V(I) is explicit, I(V) is solved
+//  in closed form with the Lambert W function. Units follow the rest of
+//  the core library: V, mA and Ohm.
+// ---------------------------------------------------------------------------
+
+// Portable core module, no Qt dependencies.
+#include "diodemodel.h"
+#include <cmath>
+
+// Returns the thermal voltage k * T / q (V).
+double DiodeModel::thermalVoltage() const noexcept
+{
+    constexpr double BoltzmannOverCharge = 8.617333262e-5; // k / q (V/K)
+    return BoltzmannOverCharge * temperature;
+}
+
+// Returns the diode voltage (V) at the given current (mA).
+double DiodeModel::voltage(double currentMilliAmp) const noexcept
+{
+    const double nVt = idealityFactor * thermalVoltage();
+    return nVt * std::log1p(currentMilliAmp / saturationCurrent) + currentMilliAmp * 1e-3 * seriesResistance;
+}
+
+// Returns the diode current (mA) at the given voltage (V).
+double DiodeModel::current(double voltage) const noexcept
+{
+    return currentThroughLoad(voltage, 0.0);
+}
+
+// Returns the current (mA) if the diode is driven from sourceVoltage (V)
+// through an additional loadResistance (Ohm), as in a curve tracer.
+double DiodeModel::currentThroughLoad(double sourceVoltage, double loadResistance) const noexcept
+{
+    const double nVt = idealityFactor * thermalVoltage();
+    const double r = (seriesResistance + loadResistance) * 1e-3; // kOhm, so V / r is in mA
+    const double is = saturationCurrent;
+
+    // Ideal diode, no resistance
+    if (r <= 0.0)
+        return is * std::expm1(sourceVoltage / nVt);
+
+    // I = nVt / R * W(Is * R / nVt * exp((V + Is * R) / nVt)) - Is
+    const double x = std::log(is * r / nVt) + (sourceVoltage + is * r) / nVt;
+    return nVt / r * LambertWExp(x) - is;
+}
+
+// Returns W(exp(x)), the Lambert W function of exp(x) (Wright omega
+// function). Evaluated in the log domain, so arguments beyond the range
+// of exp() are handled without overflow, and without underflow to
+// ln(0) for large negative x.
+double LambertWExp(double x) noexcept
+{
+    // W(z) = z - z^2 + O(z^3), exact to double precision for z < e^-20,
+    // and e^x underflows to 0 instead of feeding ln(0) to Newton
+    if (x < -20.0)
+    {
+        const double z = std::exp(x);
+        return z * (1.0 - z);
+    }
+
+    // Initial guess: W(e^x) ~ e^x for small and x - ln(x) for large x
+    double w = (x > 1.0) ? x - std::log(x) : std::exp(x) / (1.0 + std::exp(x)) * (1.0 + 0.5 * std::exp(x));
+
+    // Newton iterations on f(w) = w + ln(w) - x, converge quadratically
+    // from the initial guess. A fixed count keeps the loop branch-free.
+    for (int k = 0; k < 4; ++k)
+        w -= (w + std::log(w) - x) * w / (1.0 + w);
+
+    return w;
+}
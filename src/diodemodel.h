@@ -0,0 +1,50 @@
+// ---------------------------------------------------------------------------
+//  Shockley diode model with series resistance.
+//
+//  Describes the static I–V characteristic of a junction diode,
+//
+//      I = Is * (exp((V - I * Rs) / (n * Vt)) - 1),   Vt = k * T / q
+//
+//  and evaluates it in both directions. V(I) is explicit, I(V) is solved
+//  in closed form with the Lambert W function. Units follow the rest of
+//  the core library: V, mA and Ohm.
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+// Portable core module, no Qt dependencies.
+
+// ---------------------------------------------------------------------------
+//  DiodeModel:
+//  Parameters of a Shockley diode with series resistance. The defaults
+//  describe a small-signal silicon diode.
+// ---------------------------------------------------------------------------
+struct DiodeModel
+{
+    // Default diode temperature (K), 27 °C.
+    static constexpr double RoomTemperature = 300.15;
+
+    double saturationCurrent = 1e-7;      // Is (mA)
+    double idealityFactor = 1.7;          // n
+    double seriesResistance = 2.0;        // Rs (Ohm)
+    double temperature = RoomTemperature; // T (K)
+
+    // Returns the thermal voltage k * T / q (V).
+    double thermalVoltage() const noexcept;
+
+    // Returns the diode voltage (V) at the given current (mA).
+    double voltage(double currentMilliAmp) const noexcept;
+
+    // Returns the diode current (mA) at the given voltage (V).
+    double current(double voltage) const noexcept;
+
+    // Returns the current (mA) if the diode is driven from sourceVoltage (V)
+    // through an additional loadResistance (Ohm), as in a curve tracer.
+    double currentThroughLoad(double sourceVoltage, double loadResistance) const noexcept;
+};
+
+// Returns W(exp(x)), the Lambert W function of exp(x) (Wright omega
+// function). Evaluated in the log domain, so arguments beyond the range
+// of exp() are handled without overflow, and without underflow to
+// ln(0) for large negative x.
+double LambertWExp(double x) noexcept;
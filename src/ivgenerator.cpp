@@ -0,0 +1,111 @@
+// ---------------------------------------------------------------------------
+//  Synthetic I–V curve generator.
+//
+//  Produces measurement series as recorded by the DiodeScout: the diode is
+//  driven through a load resistor by a linear source voltage sweep, the
+//  resulting (V, I) pairs follow a DiodeModel. Parameter spread between
+//  series, measurement noise and the resolution of the device readings
+//  are configurable, so realistic datasets of any size can be created for
+//  simulation, load tests and benchmarks.
+// ---------------------------------------------------------------------------
+
+// Portable core module, no Qt dependencies.
+#include "ivgenerator.h"
+#include <algorithm>
+#include <cmath>
+
+// Returns settings for a small-signal silicon diode (e.g. 1N4148).
+IVGeneratorSettings IVGeneratorSettings::SiliconDiode()
+{
+    IVGeneratorSettings s;
+    s.model.saturationCurrent = 2.5e-7;
+    s.model.idealityFactor = 1.7;
+    s.model.seriesResistance = 2.0;
+    s.sourceVoltage = 8.5;
+    return s;
+}
+
+// Returns settings for a red LED.
+IVGeneratorSettings IVGeneratorSettings::RedLED()
+{
+    IVGeneratorSettings s;
+    s.model.saturationCurrent = 2.5e-15;
+    s.model.idealityFactor = 1.95;
+    s.model.seriesResistance = 10.0;
+    s.sourceVoltage = 7.5;
+    return s;
+}
+
+// Constructs a generator with the given settings.
+IVGenerator::IVGenerator(const IVGeneratorSettings &settings) :
+    settings_(settings),
+    random_(settings.seed)
+{
+}
+
+// Returns the generator settings.
+const IVGeneratorSettings &IVGenerator::settings() const noexcept
+{
+    return settings_;
+}
+
+// Generates the next series, replacing the contents of series.
+void IVGenerator::generate(MeasurementSeries &series)
+{
+    const std::size_t n = settings_.pointsPerSeries;
+    voltages_.resize(n);
+    currents_.resize(n);
+
+    // Device-to-device variation of the diode parameters
+    DiodeModel model = settings_.model;
+    if (settings_.parameterSpread > 0.0)
+    {
+        model.saturationCurrent *= std::exp(settings_.parameterSpread * normal_(random_));
+        model.seriesResistance *= std::exp(settings_.parameterSpread * normal_(random_));
+    }
+
+    // Linear source voltage sweep through the load resistor, one pass per
+    // column. The current pass evaluates the Lambert W function with scalar
+    // log/exp calls per point and is not vectorized; the voltage pass is
+    // a plain loop the compiler can vectorize.
+    const double step = (n > 1) ? settings_.sourceVoltage / static_cast<double>(n - 1) : 0.0;
+    const double loadKiloOhm = settings_.loadResistance * 1e-3;
+
+    for (std::size_t k = 0; k < n; ++k)
+        currents_[k] = model.currentThroughLoad(step * static_cast<double>(k), settings_.loadResistance);
+
+    for (std::size_t k = 0; k < n; ++k)
+        voltages_[k] = step * static_cast<double>(k) - currents_[k] * loadKiloOhm;
+
+    // Measurement noise and reading resolution
+    addNoise(voltages_, settings_.voltageNoise);
+    addNoise(currents_, settings_.currentNoise);
+    quantize(voltages_, settings_.voltageResolution);
+    quantize(currents_, settings_.currentResolution);
+
+    series.assign(voltages_.data(), currents_.data(), n);
+}
+
+// Adds Gaussian noise of the given deviation to all values.
+void IVGenerator::addNoise(std::vector<double> &values, double deviation)
+{
+    if (deviation <= 0.0)
+        return;
+
+    for (double &v : values)
+        v += deviation * normal_(random_);
+}
+
+// Rounds all values to the given resolution and clamps them to >= 0.
+void IVGenerator::quantize(std::vector<double> &values, double resolution) noexcept
+{
+    if (resolution > 0.0)
+    {
+        const double scale = 1.0 / resolution;
+        for (double &v : values)
+            v = std::nearbyint(v * scale) * resolution;
+    }
+
+    for (double &v : values)
+        v = std::max(v, 0.0);
+}
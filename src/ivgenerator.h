@@ -0,0 +1,78 @@
+// ---------------------------------------------------------------------------
+//  Synthetic I–V curve generator.
+//
+//  Produces measurement series as recorded by the DiodeScout: the diode is
+//  driven through a load resistor by a linear source voltage sweep, the
+//  resulting (V, I) pairs follow a DiodeModel. Parameter spread between
+//  series, measurement noise and the resolution of the device readings
+//  are configurable, so realistic datasets of any size can be created for
+//  simulation, load tests and benchmarks.
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+// Portable core module, no Qt dependencies.
+#include "coredatatypes.h"
+#include "diodemodel.h"
+#include <cstddef>
+#include <random>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+//  IVGeneratorSettings:
+//  Diode model, sweep circuit and measurement properties of a generator.
+// ---------------------------------------------------------------------------
+struct IVGeneratorSettings
+{
+    DiodeModel model;                 // nominal diode parameters
+    double sourceVoltage = 8.5;       // end of the source voltage sweep (V)
+    double loadResistance = 1000.0;   // current limiting resistor (Ohm)
+    std::size_t pointsPerSeries = 50; // points per sweep
+    double parameterSpread = 0.0;     // relative deviation of Is and Rs between series
+    double voltageNoise = 0.0;        // standard deviation (V)
+    double currentNoise = 0.0;        // standard deviation (mA)
+    double voltageResolution = 0.001; // reading resolution (V), 0 = exact
+    double currentResolution = 0.001; // reading resolution (mA), 0 = exact
+    unsigned seed = 1;                // random seed for spread and noise
+
+    // Returns settings for a small-signal silicon diode (e.g. 1N4148).
+    static IVGeneratorSettings SiliconDiode();
+
+    // Returns settings for a red LED.
+    static IVGeneratorSettings RedLED();
+};
+
+// ---------------------------------------------------------------------------
+//  IVGenerator:
+//  Generates a reproducible sequence of synthetic measurement series.
+// ---------------------------------------------------------------------------
+class IVGenerator
+{
+  public:
+    // Constructs a generator with the given settings.
+    explicit IVGenerator(const IVGeneratorSettings &settings);
+
+    // Returns the generator settings.
+    const IVGeneratorSettings &settings() const noexcept;
+
+    // Generates the next series, replacing the contents of series.
+    void generate(MeasurementSeries &series);
+
+  private:
+    // Generator settings.
+    IVGeneratorSettings settings_;
+
+    // Random source for parameter spread and noise.
+    std::mt19937 random_;
+    std::normal_distribution<double> normal_;
+
+    // Column buffers of the series being generated, reused between calls.
+    std::vector<double> voltages_;
+    std::vector<double> currents_;
+
+    // Adds Gaussian noise of the given deviation to all values.
+    void addNoise(std::vector<double> &values, double deviation);
+
+    // Rounds all values to the given resolution and clamps them to >= 0.
+    static void quantize(std::vector<double> &values, double resolution) noexcept;
+};
@@ -1,80 +1,56 @@
 // ---------------------------------------------------------------------------
 //  Entry point of the DiodeScout application. Initializes Qt, applies the
 //  dark Fusion theme, loads the application icon, establishes the serial
-//  connection to the DiodeScout device, and launches the main window.
+//  connection to the DiodeScout device (or opens a capture replay or
+//  starts a simulation), and launches the main window.
 //
 //  All UI logic and serial communication are handled by MainWindow.
 // ---------------------------------------------------------------------------
 
 #include "mainwindow.h"
+#include "replaydevice.h"
+#include "serialconnector.h"
 #include <QApplication>
+#include <QCommandLineParser>
 #include <QInputDialog>
 #include <QMessageBox>
 #include <QPalette>
-#include <QSerialPortInfo>
 #include <QStyleFactory>
 #include <clocale>
 
 // ---------------------------------------------------------------------------
-//  DiodeScoutSerialConnector:
-//  Utility class for detecting and opening a DiodeScout serial connection.
+//  Opens a DiodeScout serial connection via auto-detection
+//  or by prompting the user to select a serial port.
 // ---------------------------------------------------------------------------
-class DiodeScoutSerialConnector
+static bool FindAndOpen(QSerialPort &serial)
 {
-  public:
-    // Opens a DiodeScout serial connection via auto-detection
-    // or by prompting the user to select a serial port.
-    static bool FindAndOpen(QSerialPort &serial)
+    // 1) Try automatic detection
+    QSerialPortInfo detected;
+    if (DiodeScoutSerialConnector::Detect(detected))
+        return DiodeScoutSerialConnector::Open(serial, detected);
+
+    // 2) Ask user to select port
+    const QList<QSerialPortInfo> ports = QSerialPortInfo::availablePorts();
+    QStringList portNames;
+    for (const QSerialPortInfo &p : ports)
     {
-        // 1) Try automatic detection
-        const QList<QSerialPortInfo> ports = QSerialPortInfo::availablePorts();
-        for (const QSerialPortInfo &p : ports)
-        {
-            QString hw = p.description() + ' ' + p.manufacturer();
-            hw += ' ' + p.serialNumber() + ' ' + p.systemLocation();
-
-            if (hw.contains("DIODESCOUT", Qt::CaseInsensitive))
-                return Open(serial, p);
-        }
-
-        // 2) Ask user to select port
-        QStringList portNames;
-        for (const QSerialPortInfo &p : ports)
-        {
-            QString prettyName = p.systemLocation().remove("\\\\.\\");
-            portNames << prettyName + "   (" + p.description() + ")";
-        }
-
-        bool ok = false;
-        const QString choice = QInputDialog::getItem(nullptr, "DiodeScoutUI",
-            "No DiodeScout device detected.\nPlease select the correct serial port:", portNames, 0, false, &ok);
-
-        if (ok)
-        {
-            int index = portNames.indexOf(choice);
-            if (index >= 0)
-                return Open(serial, ports.at(index));
-        }
-
-        return false;
+        QString prettyName = p.systemLocation().remove("\\\\.\\");
+        portNames << prettyName + "   (" + p.description() + ")";
     }
 
-  private:
-    // Configures and opens the serial port.
-    static bool Open(QSerialPort &serial, const QSerialPortInfo &info)
+    bool ok = false;
+    const QString choice = QInputDialog::getItem(nullptr, "DiodeScoutUI",
+        "No DiodeScout device detected.\nPlease select the correct serial port:", portNames, 0, false, &ok);
+
+    if (ok)
     {
-        serial.setPortName(info.portName());
-
-        // Serial parameters are defined by the DiodeScout firmware;
-        // do not modify unless the device protocol changes.
-        serial.setBaudRate(QSerialPort::Baud9600);
-        serial.setDataBits(QSerialPort::Data8);
-        serial.setParity(QSerialPort::NoParity);
-        serial.setStopBits(QSerialPort::OneStop);
-        serial.setFlowControl(QSerialPort::NoFlowControl);
-        return serial.open(QIODevice::ReadWrite);
+        int index = portNames.indexOf(choice);
+        if (index >= 0)
+            return DiodeScoutSerialConnector::Open(serial, ports.at(index));
     }
-};
+
+    return false;
+}
 
 // ---------------------------------------------------------------------------
 //  Populates a QPalette with the application's dark Fusion color scheme.
@@ -110,9 +86,10 @@ int main(int argc, char *argv[])
 {
     // Initialize the main application framework
     QApplication application(argc, argv);
+    QApplication::setApplicationName("DiodeScoutUI"); // also names the data directory (journal)
 
     // Force locale-independent decimal separator ('.'),
-    // required by MeasurementDataManager and SerialParser,
+    // required by the MeasurementDataManager export functions,
     // see Qt docs: https://doc.qt.io/qt-6/qcoreapplication.html
     std::setlocale(LC_NUMERIC, "C");
     Q_ASSERT(std::string(".") == std::localeconv()->decimal_point);
@@ -128,9 +105,51 @@ int main(int argc, char *argv[])
     application.setPalette(darkPalette);
     application.setWindowIcon(QIcon(":/icons/appicon.svg"));
 
-    // Establish DiodeScout serial connection
+    // Command line: optional raw capture recording or replay
+    QCommandLineParser cmd;
+    cmd.addHelpOption();
+    const QCommandLineOption recordOpt("record", "Record the received raw data to a capture file.", "file");
+    const QCommandLineOption replayOpt("replay", "Replay a capture file instead of using a device.", "file");
+    const QCommandLineOption speedOpt("speed", "Replay speed factor, 0 = as fast as possible.", "factor", "1");
+    const QCommandLineOption simulateOpt("simulate", "Start in simulation mode with N synthetic series.", "N");
+    cmd.addOptions({recordOpt, replayOpt, speedOpt, simulateOpt});
+    cmd.process(application);
+
+    std::size_t simulatedSeries = 2;
+    if (cmd.isSet(simulateOpt))
+        simulatedSeries = cmd.value(simulateOpt).toULongLong();
+
     QSerialPort diodeScoutPort;
-    if (!DiodeScoutSerialConnector::FindAndOpen(diodeScoutPort))
+    ReplayDevice replayDevice;
+    QIODevice *dataSource = &diodeScoutPort;
+    QString sourceName;
+
+    if (cmd.isSet(replayOpt))
+    {
+        // Replay a previously recorded capture
+        bool speedOk = false;
+        const double speed = cmd.value(speedOpt).toDouble(&speedOk);
+        if (!speedOk || !replayDevice.openCapture(cmd.value(replayOpt), speed))
+        {
+            QMessageBox::critical(nullptr, "DiodeScoutUI", "Cannot replay capture file.");
+            return EXIT_FAILURE;
+        }
+
+        dataSource = &replayDevice;
+        sourceName = QString("Replay of %1").arg(cmd.value(replayOpt));
+    }
+    else if (cmd.isSet(simulateOpt))
+    {
+        // Explicit simulation (data source stays closed), e.g. to stress
+        // the chart with large datasets
+    }
+    else if (FindAndOpen(diodeScoutPort))
+    {
+        // Establish DiodeScout serial connection
+        QString prettyName = diodeScoutPort.portName().remove("\\\\.\\");
+        sourceName = QString("DiodeScout at %1").arg(prettyName);
+    }
+    else
     {
         auto result = QMessageBox::question(nullptr, "DiodeScoutUI",
             "No DiodeScout device detected.\nDo you want to start in simulation mode?",
@@ -140,8 +159,8 @@ int main(int argc, char *argv[])
             return EXIT_SUCCESS;
     }
 
-    // MainWindow enters simulation mode if the serial port is not open
-    MainWindow w(diodeScoutPort);
+    // MainWindow enters simulation mode if the data source is not open
+    MainWindow w(*dataSource, sourceName, cmd.value(recordOpt), simulatedSeries);
     w.resize(800, 600);
     w.show();
     return application.exec();
@@ -3,46 +3,101 @@
 //
 //  Responsibilities:
 //  - Creating and managing the toolbar, chart, and overall UI layout
-//  - Handling serial communication with the DiodeScout device
-//  - Forwarding incoming serial data to the SerialParser
+//  - Running serial acquisition on a dedicated worker thread
+//  - Receiving completed measurement series from the acquisition worker
 //  - Updating the chart when new measurement series become available
+//  - Drawing series decimated to the visible range and plot width, so
+//    redraws stay fast for dense and numerous curves
 //  - Providing user actions (export, reset, clear, exit)
 // ---------------------------------------------------------------------------
 
 #include "mainwindow.h"
+#include "decimation.h"
 #include "mychartview.h"
+#include <QDateTime>
 #include <QDebug>
+#include <QDialog>
+#include <QDialogButtonBox>
 #include <QFileDialog>
+#include <QHeaderView>
+#include <QKeySequence>
 #include <QLineSeries>
 #include <QMessageBox>
 #include <QSplineSeries>
+#include <QStandardPaths>
 #include <QStatusBar>
+#include <QStringList>
+#include <QTableWidget>
 #include <QToolBar>
-
-// Main window constructor.
-MainWindow::MainWindow(QSerialPort &diodeScoutPort) :
-    serial_(diodeScoutPort)
+#include <QVBoxLayout>
+#include <algorithm>
+#include <limits>
+
+// Main window constructor. Enters simulation mode with simulatedSeries
+// synthetic series if dataSource (serial port or capture replay) is not
+// open. If capturePath is not empty, the received data is recorded to
+// that capture file.
+MainWindow::MainWindow(QIODevice &dataSource, const QString &sourceName, const QString &capturePath,
+    std::size_t simulatedSeries) :
+    dataSource_(dataSource),
+    sourceName_(dataSource.isOpen() ? sourceName : QString("Simulation"))
 {
     // Initialize the main window UI, including toolbar and actions.
     setupUI();
 
+    // Recover series of a crashed run, journal newly acquired ones
+    setupJournal();
+
     // Setup data source: Use simulation if no hardware is connected,
     // otherwise initialize serial communication.
-    if (!serial_.isOpen())
+    if (!dataSource_.isOpen())
     {
-        dataManager_.appendSimulatedSeries();
+        dataManager_.appendSimulatedSeries(simulatedSeries);
         statusBar()->showMessage("Simulation");
         rebuildChart();
     }
     else
     {
-        connect(&serial_, &QSerialPort::readyRead, this, &MainWindow::onSerialDataReceived, Qt::QueuedConnection);
-        QString prettyName = serial_.portName().remove("\\\\.\\");
-        statusBar()->showMessage(QString("DiodeScout at %1").arg(prettyName));
+        statusBar()->showMessage(sourceName);
         chart_->setTitle("Press the button on the DiodeScout ...");
+
+        // Data source and worker live on the acquisition thread
+        acquisitionWorker_ = new AcquisitionWorker(dataSource_);
+        if (!capturePath.isEmpty() && !acquisitionWorker_->startRecording(capturePath.toStdString()))
+            QMessageBox::warning(this, "Error", "Cannot create capture file.");
+
+        acquisitionWorker_->moveToThread(&acquisitionThread_);
+        dataSource_.moveToThread(&acquisitionThread_);
+
+        connect(&acquisitionThread_, &QThread::finished, acquisitionWorker_, &QObject::deleteLater);
+        connect(acquisitionWorker_, &AcquisitionWorker::seriesAvailable, this, &MainWindow::onSeriesAvailable);
+        connect(acquisitionWorker_, &AcquisitionWorker::liveSeriesChanged, this, &MainWindow::onLiveSeriesChanged);
+        acquisitionThread_.start();
+
+        liveUpdateTimer_.setInterval(LiveUpdateInterval);
+        connect(&liveUpdateTimer_, &QTimer::timeout, this, &MainWindow::onLiveUpdateTimeout);
     }
 }
 
+// Main window destructor, stops the acquisition thread.
+MainWindow::~MainWindow()
+{
+    if (acquisitionWorker_)
+    {
+        // Hand the data source back before its thread terminates
+        QThread *guiThread = thread();
+        QMetaObject::invokeMethod(
+            acquisitionWorker_, [this, guiThread]() { acquisitionWorker_->stop(guiThread); },
+            Qt::BlockingQueuedConnection);
+    }
+
+    acquisitionThread_.quit();
+    acquisitionThread_.wait();
+
+    // Clean exit, nothing to recover
+    journal_.discard();
+}
+
 // Triggered when the user selects "Restore default view".
 void MainWindow::onRestoreViewClicked()
 {
@@ -67,25 +122,26 @@ void MainWindow::onDarkModeClicked()
 // Triggered when the user selects "Compute piecewise-linear diode model".
 void MainWindow::onComputePWL()
 {
+    // Several series: fit all of them and show a results table
+    if (dataManager_.seriesCount() > 1)
+    {
+        computeAllPWL();
+        return;
+    }
+
     double forwardV, seriesR;
     if (!dataManager_.computePWL(forwardV, seriesR))
     {
         QMessageBox::warning(this, "Piecewise-linear diode model",
             "Please ensure that:\n"
-            "- Exactly one measurement series is loaded\n"
+            "- At least one measurement series is loaded\n"
             "- The diode is connected with the correct polarity\n"
             "- A measurable forward current is present");
         return;
     }
 
-    // Ensure that only the diode I–V curve is visible
-    Q_ASSERT(!chart_->series().empty());
-    while (chart_->series().size() > 1)
-    {
-        auto *tmpSeries = chart_->series().at(1);
-        chart_->removeSeries(tmpSeries);
-        delete tmpSeries; // removeSeries() releases ownership!
-    }
+    // Drop model lines of earlier fits
+    removeModelSeries();
 
     const double maxI = dataManager_.maxCurrent(); // mA
 
@@ -94,26 +150,180 @@ void MainWindow::onComputePWL()
     pwlSeries->append(0.0, 0.0);
     pwlSeries->append(forwardV, 0.0);
     pwlSeries->append(forwardV + seriesR * maxI / 1000.0, maxI);
-    chart_->addSeries(pwlSeries);
+    addModelSeries(pwlSeries);
 
     QPen pen = pwlSeries->pen();
     pen.setColor(Qt::red);
     pwlSeries->setPen(pen);
 
-    auto *axisX = chartView_->getAxisX();
-    auto *axisY = chartView_->getAxisY();
-    if (axisX && axisY)
+    // Shockley model of the same series, drawn as I(V) over the measured range
+    const MeasurementSeries &seriesData = dataManager_.allSeries().front();
+    ShockleyFit fit;
+    if (FitShockleyModel(seriesData, fit))
     {
-        pwlSeries->attachAxis(axisX);
-        pwlSeries->attachAxis(axisY);
+        constexpr int ModelCurvePoints = 200;
+        const double maxV = seriesData.bounds().maxVoltage;
+
+        QList<QPointF> points;
+        points.reserve(ModelCurvePoints + 1);
+        for (int k = 0; k <= ModelCurvePoints; ++k)
+        {
+            const double v = maxV * k / ModelCurvePoints;
+            points.append(QPointF(v, fit.model.current(v)));
+        }
+
+        auto *modelSeries = new QLineSeries(chart_);
+        modelSeries->replace(points);
+        addModelSeries(modelSeries);
+
+        QPen modelPen = modelSeries->pen();
+        modelPen.setColor(Qt::green);
+        modelPen.setStyle(Qt::DashLine);
+        modelSeries->setPen(modelPen);
     }
 
     // Show model parameters in status bar
     const char *fmt = "Forward voltage (turn-on): %.2f V, Effective series resistance: %.2f \u03A9";
     QString msg = QString::asprintf(fmt, forwardV, seriesR);
+    if (fit.valid)
+        msg += " | " + shockleySummary(fit);
     statusBar()->showMessage(msg);
 }
 
+// Fits piecewise-linear and Shockley models to all stored series, draws
+// the piecewise-linear models on the chart and lists all parameters in
+// a table.
+void MainWindow::computeAllPWL()
+{
+    const std::vector<PWLModel> models = dataManager_.computeAllPWL();
+    const std::vector<ShockleyFit> fits = dataManager_.computeAllShockley();
+
+    // Drop model lines of earlier fits
+    rebuildChart();
+
+    const double maxI = dataManager_.maxCurrent(); // mA
+    std::size_t fitted = 0;
+
+    for (std::size_t i = 0; i < models.size(); ++i)
+    {
+        const PWLModel &m = models[i];
+        if (!m.valid)
+            continue;
+        ++fitted;
+
+        auto *pwlSeries = new QLineSeries(chart_);
+        pwlSeries->append(0.0, 0.0);
+        pwlSeries->append(m.forwardV, 0.0);
+        pwlSeries->append(m.forwardV + m.seriesR * maxI / 1000.0, maxI);
+        addModelSeries(pwlSeries);
+
+        // Dashed, in the color of the measured curve
+        QPen pen = pwlSeries->pen();
+        // (chartSeries_ follows the order of allSeries(), the chart may also hold the live series)
+        if (i < chartSeries_.size())
+            pen.setColor(chartSeries_[i]->color());
+        pen.setStyle(Qt::DashLine);
+        pwlSeries->setPen(pen);
+    }
+
+    statusBar()->showMessage(QString("Piecewise-linear models: %1 of %2 series fitted").arg(fitted).arg(models.size()));
+    showModelTable(models, fits);
+}
+
+// Shows the parameters of the piecewise-linear models and Shockley fits
+// of all series in a sortable table.
+void MainWindow::showModelTable(const std::vector<PWLModel> &models, const std::vector<ShockleyFit> &fits)
+{
+    auto *dialog = new QDialog(this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->setWindowTitle("Diode models");
+
+    auto *table = new QTableWidget(static_cast<int>(models.size()), 6, dialog);
+    table->setHorizontalHeaderLabels({"Series", "PWL Vf (V)", "PWL Rs (\u03A9)", "Shockley Is (A)", "Shockley n",
+        "Shockley Rs (\u03A9)"});
+    table->verticalHeader()->hide();
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    // Numeric display data, so sorting by column orders by value
+    auto setNumber = [table](int row, int column, bool valid, double value)
+    {
+        auto *item = new QTableWidgetItem;
+        if (valid)
+            item->setData(Qt::DisplayRole, value);
+        else
+            item->setText("-");
+        table->setItem(row, column, item);
+    };
+
+    for (std::size_t i = 0; i < models.size(); ++i)
+    {
+        const int row = static_cast<int>(i);
+        const PWLModel &m = models[i];
+        const ShockleyFit &f = fits[i];
+
+        setNumber(row, 0, true, row + 1);
+        setNumber(row, 1, m.valid, std::round(m.forwardV * 1000.0) / 1000.0);
+        setNumber(row, 2, m.valid, std::round(m.seriesR * 100.0) / 100.0);
+        setNumber(row, 3, f.valid, f.model.saturationCurrent * 1e-3); // mA to A
+        setNumber(row, 4, f.valid, std::round(f.model.idealityFactor * 1000.0) / 1000.0);
+        setNumber(row, 5, f.valid, std::round(f.model.seriesResistance * 100.0) / 100.0);
+    }
+
+    table->setSortingEnabled(true);
+    table->resizeColumnsToContents();
+
+    auto *buttons = new QDialogButtonBox(QDialogButtonBox::Close, dialog);
+    connect(buttons, &QDialogButtonBox::rejected, dialog, &QDialog::close);
+
+    auto *layout = new QVBoxLayout(dialog);
+    layout->addWidget(table);
+    layout->addWidget(buttons);
+
+    dialog->resize(420, 480);
+    dialog->show();
+}
+
+// Triggered when the user selects "Open session".
+void MainWindow::onOpenSessionClicked()
+{
+    QString fileName = QFileDialog::getOpenFileName(this, "Open session", QDir::homePath(),
+        "DiodeScout session (*.dss)", nullptr, QFileDialog::DontUseNativeDialog);
+
+    if (!fileName.isEmpty())
+    {
+        if (!dataManager_.loadSession(fileName.toStdString()))
+        {
+            QMessageBox::warning(this, "Error", "Cannot open session.");
+            return;
+        }
+
+        // The journal covers series acquired after the session was opened,
+        // the load itself is an undoable step like during the session
+        journal_.replaceAllSeries();
+
+        statusBar()->showMessage(QString("Session: %1 series").arg(dataManager_.seriesCount()));
+        updateHistoryActions();
+        rebuildChart();
+    }
+}
+
+// Triggered when the user selects "Save session".
+void MainWindow::onSaveSessionClicked()
+{
+    QString fileName = QFileDialog::getSaveFileName(this, "Save session", QDir::homePath() + "/dscout.dss",
+        "DiodeScout session (*.dss)", nullptr, QFileDialog::DontUseNativeDialog);
+
+    if (!fileName.isEmpty())
+    {
+        const SessionMetadata metadata = {
+            {"source", sourceName_.toStdString()},
+            {"created", QDateTime::currentDateTimeUtc().toString(Qt::ISODate).toStdString()},
+        };
+        if (!dataManager_.saveSession(fileName.toStdString(), metadata))
+            QMessageBox::warning(this, "Error", "Session save failed.");
+    }
+}
+
 // Triggered when the user selects "Export CSV".
 void MainWindow::onExportCSVClicked()
 {
@@ -169,89 +379,422 @@ void MainWindow::onExportPNGClicked()
 // Triggered when the user selects "Remove last series".
 void MainWindow::onRemoveLastClicked()
 {
-    dataManager_.removeLastSeries();
+    if (dataManager_.removeLastSeries())
+        journal_.removeLastSeries();
     statusBar()->showMessage("Ready");
+    updateHistoryActions();
     rebuildChart();
 }
 
 // Triggered when the user selects "Remove all series".
 void MainWindow::onRemoveAllClicked()
 {
-    dataManager_.removeAllSeries();
+    if (dataManager_.removeAllSeries())
+        journal_.removeAllSeries();
     statusBar()->showMessage("Ready");
+    updateHistoryActions();
     rebuildChart();
 }
 
+// Triggered when the user selects "Undo".
+void MainWindow::onUndoClicked()
+{
+    if (dataManager_.undo())
+    {
+        journal_.undo();
+        statusBar()->showMessage(QString("Undone: %1 series").arg(dataManager_.seriesCount()));
+        rebuildChart();
+    }
+    updateHistoryActions();
+}
+
+// Triggered when the user selects "Redo".
+void MainWindow::onRedoClicked()
+{
+    if (dataManager_.redo())
+    {
+        journal_.redo();
+        statusBar()->showMessage(QString("Redone: %1 series").arg(dataManager_.seriesCount()));
+        rebuildChart();
+    }
+    updateHistoryActions();
+}
+
 // Triggered when the user selects "Quit".
 void MainWindow::onQuitClicked()
 {
     qApp->quit();
 }
 
-// Reads all available serial data and forwards it to the SerialParser.
-void MainWindow::onSerialDataReceived()
+// Moves completed series from the acquisition worker into the data manager.
+void MainWindow::onSeriesAvailable()
 {
-    const QByteArray data = serial_.readAll();
+    bool added = false;
+    MeasurementSeries series;
+    PWLModel pwl;
 
-    for (char c : data)
+    while (acquisitionWorker_->takeCompletedSeries(series, pwl))
     {
-        int n;
-        const auto result = serialParser_.processReceivedChar(c);
+        // Journaled on the GUI thread, in the same order as all edits
+        journal_.appendSeries(series);
+        dataManager_.appendSeries(std::move(series));
+        appendSeriesToChart(dataManager_.allSeries().back());
+        added = true;
+    }
 
-        switch (result)
-        {
-        case ParseResult::SeriesCompleted:
-            dataManager_.appendSeries(serialParser_.currentSeries());
-            statusBar()->showMessage("Ready");
-            rebuildChart();
-            break;
-
-        case ParseResult::DataPointAdded:
-            // Update progress indicator in status bar
-            n = serialParser_.currentSeries().size();
-            statusBar()->showMessage(QString("Receiving data ") + QString(n, '.'));
-            break;
-
-        case ParseResult::ParseError:
-            qWarning() << "ParseError: " << data;
-            break;
-
-        case ParseResult::Nothing:
-            break;
-        }
+    if (!added)
+        return;
+
+    // Piecewise-linear model (fitted during reception) and live Shockley
+    // fit of the latest series
+    QStringList parts;
+    if (pwl.valid)
+        parts << pwlSummary(pwl);
+
+    ShockleyFit fit;
+    if (FitShockleyModel(dataManager_.allSeries().back(), fit))
+        parts << shockleySummary(fit);
+
+    if (!parts.isEmpty())
+        statusBar()->showMessage(QString("Series %1: %2").arg(dataManager_.seriesCount()).arg(parts.join(" | ")));
+    else
+        statusBar()->showMessage("Ready");
+}
+
+// Schedules a coalesced update of the series currently being received.
+void MainWindow::onLiveSeriesChanged()
+{
+    if (!liveUpdateTimer_.isActive())
+        liveUpdateTimer_.start();
+}
+
+// Redraws the series currently being received, at most every LiveUpdateInterval.
+void MainWindow::onLiveUpdateTimeout()
+{
+    PWLModel pwl;
+    if (!acquisitionWorker_->copyLiveSeries(liveSeriesData_, pwl))
+    {
+        // Nothing new within a whole interval, sleep until the next change
+        liveUpdateTimer_.stop();
+        return;
+    }
+
+    updateLiveChartSeries();
+
+    // Update progress indicator in status bar
+    if (!liveSeriesData_.empty())
+    {
+        const int n = static_cast<int>(liveSeriesData_.size());
+        QString msg = QString("Receiving data ") + QString(n, '.');
+        if (pwl.valid)
+            msg += " | " + pwlSummary(pwl);
+        statusBar()->showMessage(msg);
+    }
+}
+
+// Offers to recover the series of an interrupted run from the journal and
+// starts a new journal.
+void MainWindow::setupJournal()
+{
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    if (dir.isEmpty() || !QDir().mkpath(dir))
+        return;
+
+    const std::string path = QDir(dir).filePath("journal.dsj").toStdString();
+    MeasurementDataManager recovered;
+    if (SeriesJournal::Recover(path, recovered) && recovered.seriesCount() > 0)
+    {
+        auto result = QMessageBox::question(this, "DiodeScoutUI",
+            QString("The previous run ended unexpectedly.\nDo you want to recover its %1 acquired series?")
+                .arg(recovered.seriesCount()),
+            QMessageBox::Yes | QMessageBox::No);
+
+        if (result == QMessageBox::No)
+            recovered.removeAllSeries();
+    }
+
+    if (!journal_.open(path))
+    {
+        qWarning() << "Cannot create journal" << QString::fromStdString(path);
+        return;
+    }
+
+    // Journal the recovered series again, so they survive another crash
+    for (const auto &series : recovered.allSeries())
+    {
+        journal_.appendSeries(series);
+        dataManager_.appendSeries(series);
+    }
+
+    if (recovered.seriesCount() > 0)
+    {
+        statusBar()->showMessage(QString("Recovered %1 series").arg(recovered.seriesCount()));
+        rebuildChart();
     }
 }
 
+// Enables undo and redo according to the data manager's history.
+void MainWindow::updateHistoryActions()
+{
+    undoAct_->setEnabled(dataManager_.canUndo());
+    redoAct_->setEnabled(dataManager_.canRedo());
+}
+
+// Schedules a refresh of the decimated series for the new view.
+void MainWindow::onChartViewChanged()
+{
+    detailUpdateTimer_.start();
+}
+
+// Formats the parameters of a piecewise-linear model for the status bar.
+QString MainWindow::pwlSummary(const PWLModel &model) const
+{
+    return QString::asprintf("Vf = %.2f V, Rs = %.2f \u03A9", model.forwardV, model.seriesR);
+}
+
+// Formats the parameters of a Shockley fit for the status bar.
+QString MainWindow::shockleySummary(const ShockleyFit &fit) const
+{
+    const char *fmt = "Shockley model: Is = %.3g A, n = %.2f, Rs = %.2f \u03A9";
+    return QString::asprintf(fmt, fit.model.saturationCurrent * 1e-3, fit.model.idealityFactor,
+        fit.model.seriesResistance);
+}
+
 // Rounds a value up to the next 0.5 increment.
 double MainWindow::roundUpToHalf(double value) const
 {
     return std::ceil(value * 2.0) / 2.0;
 }
 
+// Creates a chart series showing seriesData decimated to at most
+// maxPoints points for the given view (V, mA).
+QXYSeries *MainWindow::createChartSeries(const MeasurementSeries &seriesData, const MeasurementBounds &view,
+    std::size_t maxPoints)
+{
+    QXYSeries *line;
+    if (seriesData.size() > MaxSplinePoints)
+        line = new QLineSeries(chart_);
+    else
+        line = new QSplineSeries(chart_);
+
+    // Bulk replace() avoids per-point change notifications
+    line->replace(chartPoints(seriesData, view, maxPoints));
+    return line;
+}
+
+// Returns the points of seriesData to draw for the given view, at most
+// maxPoints.
+QList<QPointF> MainWindow::chartPoints(const MeasurementSeries &seriesData, const MeasurementBounds &view,
+    std::size_t maxPoints) const
+{
+    std::vector<std::size_t> indices;
+    DecimateSeries(seriesData, view, maxPoints, indices);
+
+    QList<QPointF> points;
+    points.reserve(static_cast<qsizetype>(indices.size()));
+    for (std::size_t k : indices)
+        points.append(QPointF(seriesData.voltages()[k], seriesData.currents()[k]));
+    return points;
+}
+
+// Returns the visible range of the chart (V, mA); unbounded if the chart
+// has no axes.
+MeasurementBounds MainWindow::visibleBounds() const
+{
+    constexpr double Inf = std::numeric_limits<double>::infinity();
+    MeasurementBounds view;
+
+    const auto *axisX = chartView_->getAxisX();
+    const auto *axisY = chartView_->getAxisY();
+    if (axisX && axisY)
+    {
+        view.include(axisX->min(), axisY->min());
+        view.include(axisX->max(), axisY->max());
+    }
+    else
+    {
+        view.include(-Inf, -Inf);
+        view.include(Inf, Inf);
+    }
+    return view;
+}
+
+// Returns the number of points to draw per series: about one per pixel
+// column of the plot, limited by an equal share of MaxChartPoints for
+// every series on the chart.
+std::size_t MainWindow::seriesPointBudget() const
+{
+    const auto width = static_cast<std::size_t>(std::max(0.0, chart_->plotArea().width()));
+    const std::size_t seriesCount = dataManager_.seriesCount() + (liveSeriesData_.empty() ? 0 : 1);
+    const std::size_t share = MaxChartPoints / std::max<std::size_t>(seriesCount, 1);
+    return std::min(std::max(width, MinSeriesPoints), share);
+}
+
+// Redraws all series decimated for the current view and plot size.
+void MainWindow::updateChartDetail()
+{
+    const auto &all = dataManager_.allSeries();
+    if (chartSeries_.size() != all.size())
+        return; // chart is being rebuilt
+
+    const MeasurementBounds view = visibleBounds();
+    const std::size_t maxPoints = seriesPointBudget();
+    chartPointBudget_ = maxPoints;
+
+    // Redraw in place, animating the new points would lag behind the zoom
+    const auto animations = chart_->animationOptions();
+    chart_->setAnimationOptions(QChart::NoAnimation);
+    for (std::size_t k = 0; k < all.size(); ++k)
+        chartSeries_[k]->replace(chartPoints(all[k], view, maxPoints));
+    chart_->setAnimationOptions(animations);
+
+    updateLiveChartSeries();
+}
+
+// Adds a model line to the chart, attached to the current axes.
+void MainWindow::addModelSeries(QXYSeries *series)
+{
+    chart_->addSeries(series);
+    modelSeries_.push_back(series);
+
+    auto *axisX = chartView_->getAxisX();
+    auto *axisY = chartView_->getAxisY();
+    if (axisX && axisY)
+    {
+        series->attachAxis(axisX);
+        series->attachAxis(axisY);
+    }
+}
+
+// Removes and deletes all model lines.
+void MainWindow::removeModelSeries()
+{
+    for (QXYSeries *series : modelSeries_)
+    {
+        chart_->removeSeries(series);
+        delete series; // removeSeries() releases ownership!
+    }
+    modelSeries_.clear();
+}
+
 // Rebuilds the chart from all stored measurement series.
 void MainWindow::rebuildChart()
 {
     if (dataManager_.seriesCount() == 0)
     {
         resetChartToEmpty();
+        updateLiveChartSeries();
         return;
     }
 
     chart_->removeAllSeries();
+    chartSeries_.clear();
+    modelSeries_.clear();
 
+    // The view is reset to all data below
     const auto &all = dataManager_.allSeries();
+    const MeasurementBounds view = dataManager_.bounds();
+    const std::size_t maxPoints = seriesPointBudget();
+    chartPointBudget_ = maxPoints;
+    chartSeries_.reserve(all.size());
     for (const auto &seriesData : all)
     {
-        auto *line = new QSplineSeries(chart_);
-        for (const auto &p : seriesData.points())
-            line->append(p.voltageVolt, p.currentMilliAmp);
-        chart_->addSeries(line);
+        chartSeries_.push_back(createChartSeries(seriesData, view, maxPoints));
+        chart_->addSeries(chartSeries_.back());
     }
 
     chart_->setTitle(QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss"));
     chart_->createDefaultAxes();
     chart_->legend()->hide();
     chart_->setAnimationOptions(QChart::SeriesAnimations);
+    setupAxes(dataManager_.maxVoltage(), dataManager_.maxCurrent());
+
+    // removeAllSeries() also removed the live series
+    updateLiveChartSeries();
+}
+
+// Adds one newly stored series to the chart, keeping existing ones.
+void MainWindow::appendSeriesToChart(const MeasurementSeries &seriesData)
+{
+    auto *axisX = chartView_->getAxisX();
+    auto *axisY = chartView_->getAxisY();
+
+    // Empty chart (or no axes yet), a full rebuild sets everything up
+    if (chart_->series().empty() || !axisX || !axisY)
+    {
+        rebuildChart();
+        return;
+    }
+
+    auto *line = createChartSeries(seriesData, visibleBounds(), seriesPointBudget());
+    chartSeries_.push_back(line);
+    chart_->addSeries(line);
+    line->attachAxis(axisX);
+    line->attachAxis(axisY);
+    chart_->setTitle(QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss"));
+
+    // Existing series were decimated for a larger share of MaxChartPoints
+    if (seriesPointBudget() != chartPointBudget_)
+        detailUpdateTimer_.start();
+
+    // Adjust axis ranges only if the data bounds have grown
+    growAxes(dataManager_.maxVoltage(), dataManager_.maxCurrent());
+}
+
+// Synchronizes the live chart series with liveSeriesData_.
+void MainWindow::updateLiveChartSeries()
+{
+    if (liveSeriesData_.empty())
+    {
+        if (liveChartSeries_)
+        {
+            chart_->removeSeries(liveChartSeries_);
+            delete liveChartSeries_; // removeSeries() releases ownership!
+            chart_->setAnimationOptions(QChart::SeriesAnimations);
+        }
+        return;
+    }
+
+    const QList<QPointF> points = chartPoints(liveSeriesData_, visibleBounds(), seriesPointBudget());
+
+    const MeasurementBounds &bounds = liveSeriesData_.bounds();
+    if (!liveChartSeries_)
+    {
+        const bool emptyChart = chart_->series().empty();
+
+        // Straight segments are much cheaper to redraw than splines
+        liveChartSeries_ = new QLineSeries(chart_);
+        chart_->addSeries(liveChartSeries_);
+        chart_->setAnimationOptions(QChart::NoAnimation);
+
+        QPen pen = liveChartSeries_->pen();
+        pen.setStyle(Qt::DashLine);
+        liveChartSeries_->setPen(pen);
+
+        auto *axisX = chartView_->getAxisX();
+        auto *axisY = chartView_->getAxisY();
+        if (emptyChart || !axisX || !axisY)
+        {
+            chart_->createDefaultAxes();
+            chart_->legend()->hide();
+            setupAxes(bounds.maxVoltage, bounds.maxCurrent);
+        }
+        else
+        {
+            liveChartSeries_->attachAxis(axisX);
+            liveChartSeries_->attachAxis(axisY);
+        }
+    }
+
+    liveChartSeries_->replace(points);
+    growAxes(bounds.maxVoltage, bounds.maxCurrent);
+}
+
+// Sets up freshly created default axes with the given upper limits.
+void MainWindow::setupAxes(double maxVoltage, double maxCurrent)
+{
+    axisMaxVoltage_ = roundUpToHalf(maxVoltage);
+    axisMaxCurrent_ = roundUpToHalf(maxCurrent);
 
     auto *axisX = chartView_->getAxisX();
     auto *axisY = chartView_->getAxisY();
@@ -259,19 +802,49 @@ void MainWindow::rebuildChart()
     {
         axisX->setTitleText("Volt (V)");
         axisX->setTickType(QValueAxis::TicksDynamic);
-        axisX->setRange(0, roundUpToHalf(dataManager_.maxVoltage()));
+        axisX->setRange(0, axisMaxVoltage_);
         axisX->setTickInterval(0.5);
         axisX->setMinorTickCount(4);
 
         axisY->setLabelFormat("%.2f");
         axisY->setTitleText("\nMilliampere (mA)");
         axisY->setTickType(QValueAxis::TicksDynamic);
-        axisY->setRange(0, roundUpToHalf(dataManager_.maxCurrent()));
+        axisY->setRange(0, axisMaxCurrent_);
         axisY->setTickInterval(1.0);
         axisY->setMinorTickCount(4);
     }
 }
 
+// Extends the axis ranges if the given maxima exceed them.
+void MainWindow::growAxes(double maxVoltage, double maxCurrent)
+{
+    auto *axisX = chartView_->getAxisX();
+    auto *axisY = chartView_->getAxisY();
+    if (!axisX || !axisY)
+        return;
+
+    bool grown = false;
+    const double maxV = roundUpToHalf(maxVoltage);
+    if (maxV > axisMaxVoltage_)
+    {
+        axisMaxVoltage_ = maxV;
+        axisX->setRange(0, axisMaxVoltage_);
+        grown = true;
+    }
+
+    const double maxI = roundUpToHalf(maxCurrent);
+    if (maxI > axisMaxCurrent_)
+    {
+        axisMaxCurrent_ = maxI;
+        axisY->setRange(0, axisMaxCurrent_);
+        grown = true;
+    }
+
+    // Series decimated for the former view may lack points now visible
+    if (grown)
+        detailUpdateTimer_.start();
+}
+
 // Resets the chart to an empty default state.
 void MainWindow::resetChartToEmpty()
 {
@@ -279,6 +852,8 @@ void MainWindow::resetChartToEmpty()
     // initial empty-state appearance. Used when no measurement
     // series remain. Does not modify the MeasurementDataManager.
     chart_->removeAllSeries();
+    chartSeries_.clear();
+    modelSeries_.clear();
     chart_->setAnimationOptions(QChart::NoAnimation);
     chart_->setTitle("Press the button on the DiodeScout ...");
 
@@ -317,25 +892,38 @@ void MainWindow::setupUI()
     darkModeAct_ = toolbar->addAction(QIcon(":/icons/darkmode.svg"), "Dark mode");
     computePWLAct_ = toolbar->addAction(QIcon(":/icons/computepwl.svg"), "Compute piecewise-linear diode model");
     toolbar->addWidget(spacer1);
+    openSessionAct_ = toolbar->addAction(QIcon(":/icons/opensession.svg"), "Open session");
+    saveSessionAct_ = toolbar->addAction(QIcon(":/icons/savesession.svg"), "Save session");
     exportCSVAct_ = toolbar->addAction(QIcon(":/icons/exportcsv.svg"), "Export CSV (Excel)");
     exportPythonAct_ = toolbar->addAction(QIcon(":/icons/exportpython.svg"), "Export Python script");
     exportPNGAct_ = toolbar->addAction(QIcon(":/icons/exportpng.svg"), "Export PNG");
     toolbar->addWidget(spacer2);
     removeLastAct_ = toolbar->addAction(QIcon(":/icons/removelast.svg"), "Remove last series");
     removeAllAct_ = toolbar->addAction(QIcon(":/icons/removeall.svg"), "Remove all series");
+    undoAct_ = toolbar->addAction(QIcon(":/icons/undo.svg"), "Undo");
+    redoAct_ = toolbar->addAction(QIcon(":/icons/redo.svg"), "Redo");
     quitAct_ = toolbar->addAction(QIcon(":/icons/quit.svg"), "Quit");
 
     connect(restoreViewAct_, &QAction::triggered, this, &MainWindow::onRestoreViewClicked);
     connect(lightModeAct_, &QAction::triggered, this, &MainWindow::onLightModeClicked);
     connect(darkModeAct_, &QAction::triggered, this, &MainWindow::onDarkModeClicked);
     connect(computePWLAct_, &QAction::triggered, this, &MainWindow::onComputePWL);
+    connect(openSessionAct_, &QAction::triggered, this, &MainWindow::onOpenSessionClicked);
+    connect(saveSessionAct_, &QAction::triggered, this, &MainWindow::onSaveSessionClicked);
     connect(exportCSVAct_, &QAction::triggered, this, &MainWindow::onExportCSVClicked);
     connect(exportPythonAct_, &QAction::triggered, this, &MainWindow::onExportPythonClicked);
     connect(exportPNGAct_, &QAction::triggered, this, &MainWindow::onExportPNGClicked);
     connect(removeLastAct_, &QAction::triggered, this, &MainWindow::onRemoveLastClicked);
     connect(removeAllAct_, &QAction::triggered, this, &MainWindow::onRemoveAllClicked);
+    connect(undoAct_, &QAction::triggered, this, &MainWindow::onUndoClicked);
+    connect(redoAct_, &QAction::triggered, this, &MainWindow::onRedoClicked);
     connect(quitAct_, &QAction::triggered, this, &MainWindow::onQuitClicked);
 
+    undoAct_->setShortcut(QKeySequence::Undo);
+    redoAct_->setShortcut(QKeySequence::Redo);
+    undoAct_->setEnabled(false);
+    redoAct_->setEnabled(false);
+
     // Chart: chartView_ takes ownership of chart_
     chart_ = new QChart();
     chart_->setTheme(QChart::ChartThemeBlueCerulean);
@@ -346,4 +934,10 @@ void MainWindow::setupUI()
     chartView_->setRenderHint(QPainter::Antialiasing);
     chartView_->setRubberBand(QChartView::RectangleRubberBand);
     setCentralWidget(chartView_);
+
+    // Series are drawn decimated, refresh them when zoom or size change
+    detailUpdateTimer_.setSingleShot(true);
+    detailUpdateTimer_.setInterval(DetailUpdateDelay);
+    connect(&detailUpdateTimer_, &QTimer::timeout, this, &MainWindow::updateChartDetail);
+    connect(chartView_, &MyChartView::viewChanged, this, &MainWindow::onChartViewChanged);
 }
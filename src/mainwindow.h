@@ -3,19 +3,23 @@
 //
 //  Responsibilities:
 //  - Creating and managing the toolbar, chart, and overall UI layout
-//  - Handling serial communication with the DiodeScout device
-//  - Forwarding incoming serial data to the SerialParser
+//  - Running serial acquisition on a dedicated worker thread
+//  - Receiving completed measurement series from the acquisition worker
 //  - Updating the chart when new measurement series become available
 //  - Providing user actions (export, reset, clear, exit)
 // ---------------------------------------------------------------------------
 
 #pragma once
 
+#include "acquisitionworker.h"
 #include "datamanager.h"
 #include "mychartview.h"
-#include "serialparser.h"
+#include "seriesjournal.h"
 #include <QMainWindow>
-#include <QtSerialPort/QSerialPort>
+#include <QPointer>
+#include <QThread>
+#include <QTimer>
+#include <QXYSeries>
 
 // ---------------------------------------------------------------------------
 //  MainWindow:
@@ -25,9 +29,38 @@ class MainWindow : public QMainWindow
 {
     Q_OBJECT
 
+  private:
+    // Minimum interval between live chart updates (ms), about 60 Hz.
+    static constexpr int LiveUpdateInterval = 16;
+
+    // Delay before decimated series are refreshed after a view change
+    // (ms), coalesces bursts of wheel or key zoom steps.
+    static constexpr int DetailUpdateDelay = 30;
+
+    // Total number of points drawn for all stored series and the live
+    // series; bounds redraw time independent of the amount of data. Holds
+    // for up to MaxChartPoints / 3 series, as a series is drawn with at
+    // least 3 points (see DecimateSeries()).
+    static constexpr std::size_t MaxChartPoints = 200000;
+
+    // Minimum number of points drawn per series for narrow (or not yet
+    // laid out) plots, unless MaxChartPoints requires fewer.
+    static constexpr std::size_t MinSeriesPoints = 64;
+
+    // Series with more points are drawn with straight segments, splines
+    // add nothing visible at that density but are costly to tessellate.
+    static constexpr std::size_t MaxSplinePoints = 256;
+
   public:
-    // Main window constructor.
-    MainWindow(QSerialPort &diodeScoutPort);
+    // Main window constructor. Enters simulation mode with simulatedSeries
+    // synthetic series if dataSource (serial port or capture replay) is not
+    // open. If capturePath is not empty, the received data is recorded to
+    // that capture file.
+    MainWindow(QIODevice &dataSource, const QString &sourceName, const QString &capturePath,
+        std::size_t simulatedSeries = 2);
+
+    // Main window destructor, stops the acquisition thread.
+    ~MainWindow() override;
 
   private slots:
     // Triggered when the user selects "Restore default view".
@@ -42,6 +75,12 @@ class MainWindow : public QMainWindow
     // Triggered when the user selects "Compute piecewise-linear diode model".
     void onComputePWL();
 
+    // Triggered when the user selects "Open session".
+    void onOpenSessionClicked();
+
+    // Triggered when the user selects "Save session".
+    void onSaveSessionClicked();
+
     // Triggered when the user selects "Export CSV".
     void onExportCSVClicked();
 
@@ -57,21 +96,69 @@ class MainWindow : public QMainWindow
     // Triggered when the user selects "Remove all series".
     void onRemoveAllClicked();
 
+    // Triggered when the user selects "Undo".
+    void onUndoClicked();
+
+    // Triggered when the user selects "Redo".
+    void onRedoClicked();
+
     // Triggered when the user selects "Quit".
     void onQuitClicked();
 
-    // Reads all available serial data and forwards it to the SerialParser.
-    void onSerialDataReceived();
+    // Moves completed series from the acquisition worker into the data manager.
+    void onSeriesAvailable();
+
+    // Schedules a coalesced update of the series currently being received.
+    void onLiveSeriesChanged();
+
+    // Redraws the series currently being received, at most every LiveUpdateInterval.
+    void onLiveUpdateTimeout();
+
+    // Schedules a refresh of the decimated series for the new view.
+    void onChartViewChanged();
 
   private:
-    // Active serial port connection to the DiodeScout device.
-    QSerialPort &serial_;
+    // Data source, the DiodeScout serial port or a capture replay.
+    QIODevice &dataSource_;
+
+    // Name of the data source (port name, capture file or simulation),
+    // stored in saved sessions.
+    QString sourceName_;
 
     // Stores measurement series and provides analysis/export utilities.
     MeasurementDataManager dataManager_;
 
-    // Parses incoming serial data forwarded from the serial port handler.
-    SerialParser serialParser_;
+    // Crash recovery journal of the acquired series, deleted on a clean exit.
+    SeriesJournal journal_;
+
+    // Thread running serial reception and parsing.
+    QThread acquisitionThread_;
+
+    // Reads and parses serial data on acquisitionThread_ (deleted on finish).
+    AcquisitionWorker *acquisitionWorker_ = nullptr;
+
+    // Coalesces redraws of the series currently being received.
+    QTimer liveUpdateTimer_;
+
+    // Latest snapshot of the series currently being received.
+    MeasurementSeries liveSeriesData_;
+
+    // Chart series showing liveSeriesData_ (null when not shown; QPointer
+    // because the chart deletes it on removeAllSeries()).
+    QPointer<QXYSeries> liveChartSeries_;
+
+    // Chart series of the stored measurement series, same order as
+    // MeasurementDataManager::allSeries() (owned by the chart).
+    std::vector<QXYSeries *> chartSeries_;
+
+    // Chart series of fitted model lines (owned by the chart).
+    std::vector<QXYSeries *> modelSeries_;
+
+    // Coalesces refreshes of the decimated series after view changes.
+    QTimer detailUpdateTimer_;
+
+    // Points per series the chart series were last decimated to.
+    std::size_t chartPointBudget_ = 0;
 
     // Chart object and chart view (central widget).
     QChart *chart_;
@@ -82,19 +169,89 @@ class MainWindow : public QMainWindow
     QAction *lightModeAct_;
     QAction *darkModeAct_;
     QAction *computePWLAct_;
+    QAction *openSessionAct_;
+    QAction *saveSessionAct_;
     QAction *exportCSVAct_;
     QAction *exportPythonAct_;
     QAction *exportPNGAct_;
     QAction *removeLastAct_;
     QAction *removeAllAct_;
+    QAction *undoAct_;
+    QAction *redoAct_;
     QAction *quitAct_;
 
+    // Upper axis limits (V, mA) set by the last rebuild or growth.
+    double axisMaxVoltage_ = 0.0;
+    double axisMaxCurrent_ = 0.0;
+
     // Rounds a value up to the next 0.5 increment.
     double roundUpToHalf(double value) const;
 
+    // Creates a chart series showing seriesData decimated to at most
+    // maxPoints points for the given view (V, mA).
+    QXYSeries *createChartSeries(const MeasurementSeries &seriesData, const MeasurementBounds &view,
+        std::size_t maxPoints);
+
+    // Returns the points of seriesData to draw for the given view, at most
+    // maxPoints (see DecimateSeries()).
+    QList<QPointF> chartPoints(const MeasurementSeries &seriesData, const MeasurementBounds &view,
+        std::size_t maxPoints) const;
+
+    // Returns the visible range of the chart (V, mA); unbounded if the
+    // chart has no axes.
+    MeasurementBounds visibleBounds() const;
+
+    // Returns the number of points to draw per series: about one per
+    // pixel column of the plot, limited by an equal share of MaxChartPoints
+    // for every series on the chart.
+    std::size_t seriesPointBudget() const;
+
+    // Redraws all series decimated for the current view and plot size.
+    void updateChartDetail();
+
+    // Adds a model line to the chart, attached to the current axes.
+    void addModelSeries(QXYSeries *series);
+
+    // Removes and deletes all model lines.
+    void removeModelSeries();
+
     // Rebuilds the chart from all stored measurement series.
     void rebuildChart();
 
+    // Fits piecewise-linear and Shockley models to all stored series, draws
+    // the piecewise-linear models on the chart and lists all parameters in
+    // a table.
+    void computeAllPWL();
+
+    // Shows the parameters of the piecewise-linear models and Shockley fits
+    // of all series in a sortable table.
+    void showModelTable(const std::vector<PWLModel> &models, const std::vector<ShockleyFit> &fits);
+
+    // Offers to recover the series of an interrupted run from the journal
+    // and starts a new journal.
+    void setupJournal();
+
+    // Enables undo and redo according to the data manager's history.
+    void updateHistoryActions();
+
+    // Formats the parameters of a piecewise-linear model for the status bar.
+    QString pwlSummary(const PWLModel &model) const;
+
+    // Formats the parameters of a Shockley fit for the status bar.
+    QString shockleySummary(const ShockleyFit &fit) const;
+
+    // Adds one newly stored series to the chart, keeping existing ones.
+    void appendSeriesToChart(const MeasurementSeries &seriesData);
+
+    // Synchronizes the live chart series with liveSeriesData_.
+    void updateLiveChartSeries();
+
+    // Sets up freshly created default axes with the given upper limits.
+    void setupAxes(double maxVoltage, double maxCurrent);
+
+    // Extends the axis ranges if the given maxima exceed them.
+    void growAxes(double maxVoltage, double maxCurrent);
+
     // Resets the chart to an empty default state.
     void resetChartToEmpty();
 
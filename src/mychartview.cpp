@@ -6,6 +6,8 @@
 //  - Panning / scrolling support (keyboard)
 //  - Real-time coordinate tooltip display
 //  - Convenience accessors for chart axes (X/Y)
+//  - Notification of zoom, scroll and resize (e.g. to refresh decimated
+//    series for the new view)
 // ---------------------------------------------------------------------------
 
 #include "mychartview.h"
@@ -79,6 +81,20 @@ void MyChartView::leaveEvent(QEvent *event)
     QChartView::leaveEvent(event);
 }
 
+// Reports rubber band zooming (and zooming out by right click).
+void MyChartView::mouseReleaseEvent(QMouseEvent *event)
+{
+    QChartView::mouseReleaseEvent(event);
+    emit viewChanged();
+}
+
+// Reports size changes of the plot.
+void MyChartView::resizeEvent(QResizeEvent *event)
+{
+    QChartView::resizeEvent(event);
+    emit viewChanged();
+}
+
 // Handles mouse wheel input to zoom the chart view.
 void MyChartView::wheelEvent(QWheelEvent *event)
 {
@@ -91,6 +107,7 @@ void MyChartView::wheelEvent(QWheelEvent *event)
         chart()->zoom(1.0 / ZoomFactor); // zoom out
 
     event->accept();
+    emit viewChanged();
 }
 
 // Keyboard-based scrolling and zooming.
@@ -125,7 +142,10 @@ void MyChartView::keyPressEvent(QKeyEvent *event)
     }
 
     if (handled)
+    {
         event->accept();
+        emit viewChanged();
+    }
     else
         QChartView::keyPressEvent(event);
 }
@@ -6,6 +6,8 @@
 //  - Panning / scrolling support (keyboard)
 //  - Real-time coordinate tooltip display
 //  - Convenience accessors for chart axes (X/Y)
+//  - Notification of zoom, scroll and resize (e.g. to refresh decimated
+//    series for the new view)
 // ---------------------------------------------------------------------------
 
 #pragma once
@@ -36,6 +38,11 @@ class MyChartView final : public QChartView
     // Convenience accessor for the chart's vertical axis.
     QValueAxis *getAxisY() const;
 
+  signals:
+    // Emitted after the visible range or the size of the plot changed
+    // through user interaction (wheel, keys, rubber band) or resizing.
+    void viewChanged();
+
   protected:
     // Checks if value is within the axis limits.
     bool inAxisRange(qreal value, const QValueAxis *axis) const;
@@ -46,6 +53,12 @@ class MyChartView final : public QChartView
     // Cleans up tooltip state when the cursor leaves the widget.
     void leaveEvent(QEvent *event) override;
 
+    // Reports rubber band zooming (and zooming out by right click).
+    void mouseReleaseEvent(QMouseEvent *event) override;
+
+    // Reports size changes of the plot.
+    void resizeEvent(QResizeEvent *event) override;
+
     // Handles mouse wheel input to zoom the chart view.
     void wheelEvent(QWheelEvent *event) override;
 
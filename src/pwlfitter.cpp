@@ -0,0 +1,119 @@
+// ---------------------------------------------------------------------------
+//  Piecewise-linear diode model fit.
+//
+//  The model V = Vf + Rs * I is fitted by linear least squares to the
+//  conducting part of an I–V curve, i.e. all points with a current of at
+//  least half the maximum current (and above a noise floor).
+//
+//  - SolvePWL() turns accumulated regression sums into Vf and Rs
+//  - IncrementalPWLFitter maintains the sums point by point while a
+//    series is received, so the model is available without a full pass
+// ---------------------------------------------------------------------------
+
+// Portable core module, no Qt dependencies.
+#include "pwlfitter.h"
+#include <algorithm>
+#include <cmath>
+
+// Computes Vf (V) and Rs (Ohm) from regression sums of current (x, mA)
+// and voltage (y, V).
+bool SolvePWL(const RegressionSums &sums, double &forwardV, double &seriesR) noexcept
+{
+    const double n = static_cast<double>(sums.count);
+    const double sumI = sums.sumX * 1e-3; // convert mA to A
+    const double sumV = sums.sumY;
+    const double sumIV = sums.sumXY * 1e-3;
+    const double sumII = sums.sumXX * 1e-6;
+
+    // Guard against invalid or ill-conditioned regression:
+    // requires n >= 2 and non-zero variance in current (denom)
+    const double denom = (n * sumII - sumI * sumI);
+    if (n < 2 || denom < 1e-15)
+        return false;
+
+    seriesR = (n * sumIV - sumI * sumV) / denom;
+    forwardV = (sumV - seriesR * sumI) / n;
+
+    // Sanity checks
+    if (!std::isfinite(seriesR) || !std::isfinite(forwardV))
+        return false;
+    if (seriesR <= 0.0 || forwardV <= 0.0)
+        return false;
+
+    return true;
+}
+
+// Constructs an empty fitter.
+IncrementalPWLFitter::IncrementalPWLFitter()
+{
+    selected_.reserve(InitialPointCapacity);
+}
+
+// Removes all points, keeping the allocated capacity for reuse.
+void IncrementalPWLFitter::reset() noexcept
+{
+    selected_.clear();
+    sums_ = RegressionSums{};
+    maxCurrent_ = 0.0;
+    pointCount_ = 0;
+}
+
+// Adds a measurement point and updates the fit.
+void IncrementalPWLFitter::addPoint(double voltage, double currentMilliAmp)
+{
+    constexpr auto ByCurrent = [](const Sample &a, const Sample &b) { return a.current > b.current; };
+
+    ++pointCount_;
+    maxCurrent_ = std::max(maxCurrent_, currentMilliAmp);
+    const double limit = threshold();
+
+    // Evict points the risen threshold has passed
+    while (!selected_.empty() && selected_.front().current < limit)
+    {
+        const Sample &s = selected_.front();
+        --sums_.count;
+        sums_.sumX -= s.current;
+        sums_.sumY -= s.voltage;
+        sums_.sumXY -= s.current * s.voltage;
+        sums_.sumXX -= s.current * s.current;
+
+        std::pop_heap(selected_.begin(), selected_.end(), ByCurrent);
+        selected_.pop_back();
+    }
+
+    // Drop the rounding residue of the subtractions
+    if (selected_.empty())
+        sums_ = RegressionSums{};
+
+    if (!(currentMilliAmp >= limit))
+        return;
+
+    ++sums_.count;
+    sums_.sumX += currentMilliAmp;
+    sums_.sumY += voltage;
+    sums_.sumXY += currentMilliAmp * voltage;
+    sums_.sumXX += currentMilliAmp * currentMilliAmp;
+
+    selected_.push_back(Sample{currentMilliAmp, voltage});
+    std::push_heap(selected_.begin(), selected_.end(), ByCurrent);
+}
+
+// Returns the number of points added since the last reset().
+std::size_t IncrementalPWLFitter::pointCount() const noexcept
+{
+    return pointCount_;
+}
+
+// Returns the model of all points added so far.
+PWLModel IncrementalPWLFitter::model() const noexcept
+{
+    PWLModel m;
+    m.valid = SolvePWL(sums_, m.forwardV, m.seriesR);
+    return m;
+}
+
+// Returns the current selection threshold (mA).
+double IncrementalPWLFitter::threshold() const noexcept
+{
+    return std::max(PWLThresholdRatio * maxCurrent_, PWLNoiseFloor);
+}
@@ -0,0 +1,96 @@
+// ---------------------------------------------------------------------------
+//  Piecewise-linear diode model fit.
+//
+//  The model V = Vf + Rs * I is fitted by linear least squares to the
+//  conducting part of an I–V curve, i.e. all points with a current of at
+//  least half the maximum current (and above a noise floor).
+//
+//  - SolvePWL() turns accumulated regression sums into Vf and Rs
+//  - IncrementalPWLFitter maintains the sums point by point while a
+//    series is received, so the model is available without a full pass
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+// Portable core module, no Qt dependencies.
+#include "columnkernels.h"
+#include <cstddef>
+#include <vector>
+
+// Points below this current (mA) never contribute to the fit.
+constexpr double PWLNoiseFloor = 0.1;
+
+// Points below this fraction of the maximum current are not conducting.
+constexpr double PWLThresholdRatio = 0.5;
+
+// ---------------------------------------------------------------------------
+//  PWLModel:
+//  Piecewise-linear diode model of a single measurement series.
+// ---------------------------------------------------------------------------
+struct PWLModel
+{
+    double forwardV = 0.0; // forward (turn-on) voltage (V)
+    double seriesR = 0.0;  // effective series resistance (Ohm)
+    bool valid = false;    // false if the series could not be fitted
+};
+
+// Computes Vf (V) and Rs (Ohm) from regression sums of current (x, mA)
+// and voltage (y, V). Returns true if the fit is well-conditioned and
+// physically plausible.
+bool SolvePWL(const RegressionSums &sums, double &forwardV, double &seriesR) noexcept;
+
+// ---------------------------------------------------------------------------
+//  IncrementalPWLFitter:
+//  Piecewise-linear fit updated in O(log n) per added point. Gives the
+//  same model as a full fit over all added points.
+//
+//  The selection threshold only rises with the maximum current, so a
+//  point that drops below it never qualifies again. Selected points are
+//  kept in a min-heap by current and evicted from the sums as the
+//  threshold passes them.
+// ---------------------------------------------------------------------------
+class IncrementalPWLFitter
+{
+  private:
+    // Initial heap capacity, based on the typical series size.
+    static constexpr std::size_t InitialPointCapacity = 64;
+
+  public:
+    // Constructs an empty fitter.
+    IncrementalPWLFitter();
+
+    // Removes all points, keeping the allocated capacity for reuse.
+    void reset() noexcept;
+
+    // Adds a measurement point and updates the fit.
+    void addPoint(double voltage, double currentMilliAmp);
+
+    // Returns the number of points added since the last reset().
+    std::size_t pointCount() const noexcept;
+
+    // Returns the model of all points added so far.
+    PWLModel model() const noexcept;
+
+  private:
+    // A selected point, ordered by current.
+    struct Sample
+    {
+        double current;
+        double voltage;
+    };
+
+    // Selected points (current >= threshold), min-heap by current.
+    std::vector<Sample> selected_;
+
+    // Regression sums over selected_.
+    RegressionSums sums_;
+
+    // Maximum current of all added points (mA).
+    double maxCurrent_ = 0.0;
+
+    // Number of points added since the last reset().
+    std::size_t pointCount_ = 0;
+
+    // Returns the current selection threshold (mA).
+    double threshold() const noexcept;
+};
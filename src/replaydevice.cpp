@@ -0,0 +1,114 @@
+// ---------------------------------------------------------------------------
+//  Replay of raw serial capture files
+//
+//  Sequential, read-only QIODevice that plays back a capture file written
+//  by CaptureWriter. It can stand in for the serial port anywhere in the
+//  acquisition path, at the original timing, N times faster, or as fast
+//  as possible.
+//
+//  - readyRead() is emitted whenever captured chunks become due
+//  - readChannelFinished() is emitted after the last chunk
+// ---------------------------------------------------------------------------
+
+#include "replaydevice.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Constructs a closed replay device.
+ReplayDevice::ReplayDevice(QObject *parent) :
+    QIODevice(parent),
+    timer_(this)
+{
+    timer_.setSingleShot(true);
+    connect(&timer_, &QTimer::timeout, this, &ReplayDevice::deliverDueChunks);
+}
+
+// Opens a capture file and starts playback. speed is the replay rate
+// relative to the original timing; 0 replays as fast as possible.
+// Returns true on success.
+bool ReplayDevice::openCapture(const QString &filePath, double speed)
+{
+    if (isOpen() || speed < 0.0 || !reader_.open(filePath.toStdString()))
+        return false;
+
+    speed_ = speed;
+    hasNextChunk_ = reader_.next(nextChunk_);
+    firstTimestampMicros_ = hasNextChunk_ ? nextChunk_.timestampMicros : 0;
+    buffer_.clear();
+
+    QIODevice::open(QIODevice::ReadOnly);
+    clock_.start();
+    timer_.start(0);
+    return true;
+}
+
+// Replay devices are sequential.
+bool ReplayDevice::isSequential() const
+{
+    return true;
+}
+
+// Returns the number of delivered bytes not yet read.
+qint64 ReplayDevice::bytesAvailable() const
+{
+    return buffer_.size() + QIODevice::bytesAvailable();
+}
+
+// Reads delivered bytes.
+qint64 ReplayDevice::readData(char *data, qint64 maxSize)
+{
+    const qint64 n = std::min<qint64>(maxSize, buffer_.size());
+    std::memcpy(data, buffer_.constData(), static_cast<std::size_t>(n));
+    buffer_.remove(0, n);
+    return n;
+}
+
+// Replay devices are read-only.
+qint64 ReplayDevice::writeData(const char *, qint64)
+{
+    return -1;
+}
+
+// Delivers all chunks that are due and schedules the next one.
+void ReplayDevice::deliverDueChunks()
+{
+    const double elapsedMicros = static_cast<double>(clock_.nsecsElapsed()) / 1000.0;
+    bool delivered = false;
+
+    // Replay time at which nextChunk_ is due (speed_ > 0 only)
+    auto dueMicros = [this]()
+    {
+        const std::uint64_t ts = std::max(nextChunk_.timestampMicros, firstTimestampMicros_);
+        return static_cast<double>(ts - firstTimestampMicros_) / speed_;
+    };
+
+    while (hasNextChunk_)
+    {
+        if (speed_ > 0.0 && dueMicros() > elapsedMicros)
+            break;
+
+        buffer_.append(nextChunk_.data.data(), static_cast<qsizetype>(nextChunk_.data.size()));
+        hasNextChunk_ = reader_.next(nextChunk_);
+        delivered = true;
+
+        // Full speed: one captured chunk per event loop pass, so the
+        // receiver sees the original chunking
+        if (speed_ <= 0.0)
+            break;
+    }
+
+    if (delivered)
+        emit readyRead();
+
+    if (!hasNextChunk_)
+    {
+        emit readChannelFinished();
+        return;
+    }
+
+    int delayMs = 0;
+    if (speed_ > 0.0)
+        delayMs = static_cast<int>(std::ceil((dueMicros() - elapsedMicros) / 1000.0));
+    timer_.start(std::max(0, delayMs));
+}
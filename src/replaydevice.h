@@ -0,0 +1,76 @@
+// ---------------------------------------------------------------------------
+//  Replay of raw serial capture files
+//
+//  Sequential, read-only QIODevice that plays back a capture file written
+//  by CaptureWriter. It can stand in for the serial port anywhere in the
+//  acquisition path, at the original timing, N times faster, or as fast
+//  as possible.
+//
+//  - readyRead() is emitted whenever captured chunks become due
+//  - readChannelFinished() is emitted after the last chunk
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+#include "capturefile.h"
+#include <QElapsedTimer>
+#include <QIODevice>
+#include <QTimer>
+
+// ---------------------------------------------------------------------------
+//  ReplayDevice:
+//  Plays back a raw serial capture file as a QIODevice.
+// ---------------------------------------------------------------------------
+class ReplayDevice : public QIODevice
+{
+    Q_OBJECT
+
+  public:
+    // Constructs a closed replay device.
+    explicit ReplayDevice(QObject *parent = nullptr);
+
+    // Opens a capture file and starts playback. speed is the replay rate
+    // relative to the original timing; 0 replays as fast as possible.
+    // Returns true on success.
+    bool openCapture(const QString &filePath, double speed);
+
+    // Replay devices are sequential.
+    bool isSequential() const override;
+
+    // Returns the number of delivered bytes not yet read.
+    qint64 bytesAvailable() const override;
+
+  protected:
+    // Reads delivered bytes.
+    qint64 readData(char *data, qint64 maxSize) override;
+
+    // Replay devices are read-only.
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+  private slots:
+    // Delivers all chunks that are due and schedules the next one.
+    void deliverDueChunks();
+
+  private:
+    // Source capture file.
+    CaptureReader reader_;
+
+    // Next chunk to deliver, valid if hasNextChunk_ is set.
+    CaptureChunk nextChunk_;
+    bool hasNextChunk_ = false;
+
+    // Timestamp of the first chunk, replay starts immediately with it.
+    std::uint64_t firstTimestampMicros_ = 0;
+
+    // Replay rate, 0 = as fast as possible.
+    double speed_ = 1.0;
+
+    // Delivered bytes not yet read.
+    QByteArray buffer_;
+
+    // Measures the replay time since openCapture().
+    QElapsedTimer clock_;
+
+    // Fires when the next chunk is due (child object, follows moveToThread()).
+    QTimer timer_;
+};
@@ -0,0 +1,205 @@
+// ---------------------------------------------------------------------------
+//  Pooled storage for measurement sample columns.
+//
+//  Every size class (multiples of Alignment up to MaxBlockSize) has a free
+//  list of released blocks and carves new blocks sequentially from its
+//  current chunk. Free blocks store the free-list link in their first
+//  bytes. Chunks are aligned to their size and start with a header that
+//  links the chunk list (so chunks stay reachable and are not reported
+//  as leaks) and counts the live blocks, which releaseUnused() uses to
+//  find empty chunks.
+// ---------------------------------------------------------------------------
+
+// Portable core module, no Qt dependencies.
+#include "samplepool.h"
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+static_assert(SamplePool::MaxBlockSize % SamplePool::Alignment == 0, "Block sizes are multiples of the alignment");
+static_assert(SamplePool::ChunkSize >= 2 * SamplePool::MaxBlockSize, "Chunks hold several blocks of every size");
+
+// Number of size classes.
+static constexpr std::size_t SizeClassCount = SamplePool::MaxBlockSize / SamplePool::Alignment;
+
+// ---------------------------------------------------------------------------
+//  A released block, linked into the free list of its size class.
+// ---------------------------------------------------------------------------
+struct FreeBlock
+{
+    FreeBlock *next;
+};
+
+// ---------------------------------------------------------------------------
+//  Header in the first cache line of every chunk. A chunk serves blocks
+//  of a single size class.
+// ---------------------------------------------------------------------------
+struct ChunkHeader
+{
+    ChunkHeader *next = nullptr;  // previously allocated chunk
+    std::size_t sizeClass = 0;    // index of the size class served
+    std::size_t liveBlocks = 0;   // blocks handed out and not released
+};
+
+static_assert(sizeof(ChunkHeader) <= SamplePool::Alignment, "Chunk header fits into the first cache line");
+
+// ---------------------------------------------------------------------------
+//  Blocks of one size.
+// ---------------------------------------------------------------------------
+struct SizeClass
+{
+    FreeBlock *freeList = nullptr;
+    unsigned char *carve = nullptr;    // next unused block of the current chunk
+    unsigned char *carveEnd = nullptr; // end of the current chunk
+};
+
+// ---------------------------------------------------------------------------
+//  Pool state, constant-initialized so it is usable during static
+//  initialization of other modules.
+// ---------------------------------------------------------------------------
+struct PoolState
+{
+    std::mutex mutex;
+    SizeClass classes[SizeClassCount];
+    ChunkHeader *chunks = nullptr; // most recent chunk
+    std::size_t chunkCount = 0;
+};
+
+static PoolState Pool;
+
+// Allocates raw memory from the heap with the given alignment.
+static void *HeapAllocate(std::size_t size, std::size_t alignment = SamplePool::Alignment)
+{
+    return ::operator new(size, std::align_val_t(alignment));
+}
+
+// Releases memory obtained from HeapAllocate() with the same alignment.
+static void HeapDeallocate(void *p, std::size_t alignment = SamplePool::Alignment) noexcept
+{
+    ::operator delete(p, std::align_val_t(alignment));
+}
+
+// Returns the size class index for a block size in (0, MaxBlockSize].
+static std::size_t SizeClassIndex(std::size_t size) noexcept
+{
+    return (size - 1) / SamplePool::Alignment;
+}
+
+// Returns the chunk a pooled block was carved from. Chunks are aligned
+// to their size, so this is the block address rounded down.
+static ChunkHeader *ChunkOf(const void *block) noexcept
+{
+    const auto address = reinterpret_cast<std::uintptr_t>(block);
+    return reinterpret_cast<ChunkHeader *>(address & ~std::uintptr_t{SamplePool::ChunkSize - 1});
+}
+
+// Returns a block of at least size bytes aligned to Alignment.
+void *SamplePool::allocate(std::size_t size)
+{
+    if (size == 0)
+        size = 1;
+    if (size > MaxBlockSize)
+        return HeapAllocate(size);
+
+    const std::size_t index = SizeClassIndex(size);
+    const std::size_t blockSize = (index + 1) * Alignment;
+
+    std::lock_guard<std::mutex> lock(Pool.mutex);
+    SizeClass &sizeClass = Pool.classes[index];
+
+    if (FreeBlock *block = sizeClass.freeList)
+    {
+        sizeClass.freeList = block->next;
+        ++ChunkOf(block)->liveBlocks;
+        return block;
+    }
+
+    // Start a new chunk; its first cache line holds the chunk header
+    if (static_cast<std::size_t>(sizeClass.carveEnd - sizeClass.carve) < blockSize)
+    {
+        auto *chunk = static_cast<unsigned char *>(HeapAllocate(ChunkSize, ChunkSize));
+        auto *header = new (chunk) ChunkHeader;
+        header->next = Pool.chunks;
+        header->sizeClass = index;
+        Pool.chunks = header;
+        ++Pool.chunkCount;
+
+        sizeClass.carve = chunk + Alignment;
+        sizeClass.carveEnd = chunk + ChunkSize;
+    }
+
+    void *block = sizeClass.carve;
+    sizeClass.carve += blockSize;
+    ++ChunkOf(block)->liveBlocks;
+    return block;
+}
+
+// Releases a block obtained from allocate() with the same size.
+void SamplePool::deallocate(void *block, std::size_t size) noexcept
+{
+    if (!block)
+        return;
+    if (size > MaxBlockSize)
+    {
+        HeapDeallocate(block);
+        return;
+    }
+
+    SizeClass &sizeClass = Pool.classes[SizeClassIndex(size == 0 ? 1 : size)];
+    auto *freeBlock = static_cast<FreeBlock *>(block);
+
+    std::lock_guard<std::mutex> lock(Pool.mutex);
+    freeBlock->next = sizeClass.freeList;
+    sizeClass.freeList = freeBlock;
+    --ChunkOf(block)->liveBlocks;
+}
+
+// Returns chunks without allocated blocks to the heap.
+std::size_t SamplePool::releaseUnused() noexcept
+{
+    std::lock_guard<std::mutex> lock(Pool.mutex);
+
+    // Unlink the free blocks of empty chunks
+    for (SizeClass &sizeClass : Pool.classes)
+    {
+        FreeBlock **link = &sizeClass.freeList;
+        while (*link)
+        {
+            if (ChunkOf(*link)->liveBlocks == 0)
+                *link = (*link)->next;
+            else
+                link = &(*link)->next;
+        }
+    }
+
+    std::size_t released = 0;
+    ChunkHeader **link = &Pool.chunks;
+    while (ChunkHeader *chunk = *link)
+    {
+        if (chunk->liveBlocks != 0)
+        {
+            link = &chunk->next;
+            continue;
+        }
+
+        // The size class no longer carves from a released chunk
+        auto *begin = reinterpret_cast<unsigned char *>(chunk);
+        SizeClass &sizeClass = Pool.classes[chunk->sizeClass];
+        if (sizeClass.carveEnd == begin + ChunkSize)
+            sizeClass.carve = sizeClass.carveEnd = nullptr;
+
+        *link = chunk->next;
+        HeapDeallocate(chunk, ChunkSize);
+        --Pool.chunkCount;
+        released += ChunkSize;
+    }
+
+    return released;
+}
+
+// Returns the bytes of all chunks allocated by the pool.
+std::size_t SamplePool::reservedBytes() noexcept
+{
+    std::lock_guard<std::mutex> lock(Pool.mutex);
+    return Pool.chunkCount * ChunkSize;
+}
@@ -0,0 +1,111 @@
+// ---------------------------------------------------------------------------
+//  Pooled storage for measurement sample columns.
+//
+//  A measurement series holds two small columns of a few hundred bytes, and
+//  a long acquisition session creates thousands of them. Instead of one
+//  heap allocation per column, SamplePool carves fixed-size blocks out of
+//  large chunks and keeps released blocks in per-size free lists:
+//  - Allocating and releasing a block is a free-list pop or push, without
+//    calls into the system allocator once the pool has grown
+//  - Columns of consecutively acquired series lie next to each other in
+//    memory, which keeps scans over many series cache friendly
+//  - Memory freed by removing series does not fragment the heap, it is
+//    reused by the next series of a similar size
+//  Blocks larger than MaxBlockSize are allocated from the heap directly.
+//  Every size class in use holds at least one chunk, so up to
+//  MaxBlockSize / Alignment * ChunkSize (32 MiB) stay reserved while
+//  blocks of all sizes are in use. Chunks are kept until releaseUnused()
+//  returns those without allocated blocks to the heap.
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+// Portable core module, no Qt dependencies.
+#include <cstddef>
+
+// ---------------------------------------------------------------------------
+//  SamplePool:
+//  Thread-safe pool of cache line aligned blocks.
+// ---------------------------------------------------------------------------
+class SamplePool
+{
+  public:
+    // Alignment of all blocks (bytes), one cache line. Block sizes are
+    // rounded up to multiples of it.
+    static constexpr std::size_t Alignment = 64;
+
+    // Largest block served from the pool (bytes), 1024 samples.
+    static constexpr std::size_t MaxBlockSize = 8192;
+
+    // Size of the chunks blocks are carved from (bytes).
+    static constexpr std::size_t ChunkSize = 256 * 1024;
+
+    // Returns a block of at least size bytes aligned to Alignment.
+    // Safe to call from any thread.
+    static void *allocate(std::size_t size);
+
+    // Releases a block obtained from allocate() with the same size.
+    // Safe to call from any thread.
+    static void deallocate(void *block, std::size_t size) noexcept;
+
+    // Returns chunks without allocated blocks to the heap, e.g. after
+    // many series were released. Returns the number of bytes released.
+    // Safe to call from any thread.
+    static std::size_t releaseUnused() noexcept;
+
+    // Returns the bytes of all chunks allocated by the pool.
+    static std::size_t reservedBytes() noexcept;
+};
+
+// ---------------------------------------------------------------------------
+//  SampleAllocator:
+//  Standard allocator for arrays of T backed by SamplePool.
+// ---------------------------------------------------------------------------
+template <typename T>
+class SampleAllocator
+{
+    static_assert(SamplePool::Alignment >= alignof(T), "Pool alignment must satisfy the alignment of T");
+
+  public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = SampleAllocator<U>;
+    };
+
+    // Constructs an allocator, allocators are stateless.
+    SampleAllocator() noexcept = default;
+
+    // Converting constructor required by the allocator requirements.
+    template <typename U>
+    SampleAllocator(const SampleAllocator<U> &) noexcept
+    {
+    }
+
+    // Allocates storage for n objects of T.
+    T *allocate(std::size_t n)
+    {
+        return static_cast<T *>(SamplePool::allocate(n * sizeof(T)));
+    }
+
+    // Releases storage obtained from allocate().
+    void deallocate(T *p, std::size_t n) noexcept
+    {
+        SamplePool::deallocate(p, n * sizeof(T));
+    }
+
+    // All instances share the pool and are interchangeable.
+    template <typename U>
+    bool operator==(const SampleAllocator<U> &) const noexcept
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const SampleAllocator<U> &) const noexcept
+    {
+        return false;
+    }
+};
@@ -0,0 +1,51 @@
+// ---------------------------------------------------------------------------
+//  Detection and configuration of DiodeScout serial connections.
+//
+//  Shared by the desktop application and the headless command-line tool.
+//  Only depends on QtCore and QtSerialPort; interactive port selection is
+//  left to the caller.
+// ---------------------------------------------------------------------------
+
+#include "serialconnector.h"
+
+// Searches the available serial ports for a DiodeScout device.
+// Returns true and fills info if a device was found.
+bool DiodeScoutSerialConnector::Detect(QSerialPortInfo &info)
+{
+    const QList<QSerialPortInfo> ports = QSerialPortInfo::availablePorts();
+    for (const QSerialPortInfo &p : ports)
+    {
+        QString hw = p.description() + ' ' + p.manufacturer();
+        hw += ' ' + p.serialNumber() + ' ' + p.systemLocation();
+
+        if (hw.contains("DIODESCOUT", Qt::CaseInsensitive))
+        {
+            info = p;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Configures and opens the serial port.
+bool DiodeScoutSerialConnector::Open(QSerialPort &serial, const QSerialPortInfo &info)
+{
+    return Open(serial, info.portName());
+}
+
+// Configures and opens the serial port with the given name or system
+// location (e.g. "COM3" or "/dev/ttyUSB0").
+bool DiodeScoutSerialConnector::Open(QSerialPort &serial, const QString &portName)
+{
+    serial.setPortName(portName);
+
+    // Serial parameters are defined by the DiodeScout firmware;
+    // do not modify unless the device protocol changes.
+    serial.setBaudRate(QSerialPort::Baud9600);
+    serial.setDataBits(QSerialPort::Data8);
+    serial.setParity(QSerialPort::NoParity);
+    serial.setStopBits(QSerialPort::OneStop);
+    serial.setFlowControl(QSerialPort::NoFlowControl);
+    return serial.open(QIODevice::ReadWrite);
+}
@@ -0,0 +1,31 @@
+// ---------------------------------------------------------------------------
+//  Detection and configuration of DiodeScout serial connections.
+//
+//  Shared by the desktop application and the headless command-line tool.
+//  Only depends on QtCore and QtSerialPort; interactive port selection is
+//  left to the caller.
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+#include <QtSerialPort/QSerialPort>
+#include <QtSerialPort/QSerialPortInfo>
+
+// ---------------------------------------------------------------------------
+//  DiodeScoutSerialConnector:
+//  Utility class for detecting and opening a DiodeScout serial connection.
+// ---------------------------------------------------------------------------
+class DiodeScoutSerialConnector
+{
+  public:
+    // Searches the available serial ports for a DiodeScout device.
+    // Returns true and fills info if a device was found.
+    static bool Detect(QSerialPortInfo &info);
+
+    // Configures and opens the serial port.
+    static bool Open(QSerialPort &serial, const QSerialPortInfo &info);
+
+    // Configures and opens the serial port with the given name or system
+    // location (e.g. "COM3" or "/dev/ttyUSB0").
+    static bool Open(QSerialPort &serial, const QString &portName);
+};
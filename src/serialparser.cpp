@@ -3,25 +3,57 @@
 //  It detects BEGIN/END blocks, parses DATA lines, and builds a
 //  MeasurementSeries from the incoming character stream.
 //
-//  - Call processReceivedChar() for each incoming character.
+//  - Call processReceivedChar() for each incoming character, or
+//    processReceivedChunk() for a whole block of received data.
 //  - When SeriesCompleted is returned, the current series
 //    contains a fully parsed measurement sequence.
+//
+//  The parser is a template over its protocol limits; the variants used by
+//  the application are explicitly instantiated at the end of this file.
 // ---------------------------------------------------------------------------
 
 // Portable core module, no Qt dependencies.
 #include "serialparser.h"
-#include <cstdlib>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
 
 // Returns a read-only reference to the current measurement series.
 // The series is parser-owned and may change as parsing continues.
-const MeasurementSeries &SerialParser::currentSeries() const noexcept
+template <typename Limits>
+const MeasurementSeries &BasicSerialParser<Limits>::currentSeries() const noexcept
 {
     return currentSeries_;
 }
 
+// Moves the current series into series and continues with the former
+// storage of series.
+template <typename Limits>
+void BasicSerialParser<Limits>::releaseSeries(MeasurementSeries &series) noexcept
+{
+    std::swap(currentSeries_, series);
+    currentSeries_.clear();
+}
+
+// Returns true while a series is being received (between BEGIN and END).
+template <typename Limits>
+bool BasicSerialParser<Limits>::receivingSeries() const noexcept
+{
+    return state_ == ParserState::ReceivingSeries;
+}
+
+// Returns a counter that is incremented whenever a new series starts.
+template <typename Limits>
+std::uint64_t BasicSerialParser<Limits>::seriesSequence() const noexcept
+{
+    return seriesSequence_;
+}
+
 // Returns DataPointAdded when a DATA line is parsed, SeriesCompleted when
 // END is received, ParseError on invalid input, or Nothing otherwise.
-ParseResult SerialParser::processReceivedChar(char c)
+template <typename Limits>
+ParseResult BasicSerialParser<Limits>::processReceivedChar(char c)
 {
     if (c == '\n')
     {
@@ -36,7 +68,7 @@ ParseResult SerialParser::processReceivedChar(char c)
         return ParseResult::Nothing;
     }
 
-    if (lineBuffer_.size() >= MaxLineLength)
+    if (lineBuffer_.size() >= Limits::MaxLineLength)
     {
         // Prevent unbounded buffer growth on malformed input
         lineBuffer_.clear();
@@ -47,38 +79,117 @@ ParseResult SerialParser::processReceivedChar(char c)
     return ParseResult::Nothing;
 }
 
+// Processes a block of received characters and returns the events it
+// produced (Nothing results are omitted). Processing stops right after
+// a SeriesCompleted event so the caller can consume currentSeries();
+// 'consumed' receives the number of characters processed. The returned
+// list is parser-owned and valid until the next call.
+template <typename Limits>
+const std::vector<ParseEvent> &BasicSerialParser<Limits>::processReceivedChunk(
+    std::string_view chunk, std::size_t &consumed)
+{
+    chunkEvents_.clear();
+    std::size_t pos = 0;
+
+    while (pos < chunk.size())
+    {
+        const char *segBegin = chunk.data() + pos;
+        const auto *newline = static_cast<const char *>(std::memchr(segBegin, '\n', chunk.size() - pos));
+        const std::size_t segEnd = newline ? static_cast<std::size_t>(newline - chunk.data()) : chunk.size();
+
+        // CRLF normalization
+        std::string_view segment(segBegin, segEnd - pos);
+        if (!segment.empty() && segment.back() == '\r')
+            segment.remove_suffix(1);
+
+        // Embedded CRs and overlong lines are rare; hand them to the
+        // per-character path so both entry points behave identically
+        const bool bulk = segment.find('\r') == std::string_view::npos &&
+                          lineBuffer_.size() + segment.size() <= Limits::MaxLineLength;
+        if (!bulk)
+        {
+            const std::size_t end = newline ? segEnd + 1 : chunk.size();
+            for (; pos < end; ++pos)
+            {
+                const auto result = processReceivedChar(chunk[pos]);
+                if (result != ParseResult::Nothing)
+                    chunkEvents_.emplace_back(result, pos);
+            }
+
+            if (!chunkEvents_.empty() && chunkEvents_.back().result == ParseResult::SeriesCompleted)
+                break;
+            continue;
+        }
+
+        // Incomplete line, keep it until the rest arrives
+        if (!newline)
+        {
+            lineBuffer_.append(segment);
+            pos = chunk.size();
+            break;
+        }
+
+        ParseResult result;
+        if (lineBuffer_.empty())
+        {
+            result = handleCompletedLine(segment);
+        }
+        else
+        {
+            lineBuffer_.append(segment);
+            result = handleCompletedLine(lineBuffer_);
+            lineBuffer_.clear();
+        }
+
+        pos = segEnd + 1;
+        if (result != ParseResult::Nothing)
+            chunkEvents_.emplace_back(result, segEnd);
+        if (result == ParseResult::SeriesCompleted)
+            break;
+    }
+
+    consumed = pos;
+    return chunkEvents_;
+}
+
 // Processes a fully received line and updates the parser state.
-ParseResult SerialParser::handleCompletedLine(const std::string &rawLine)
+template <typename Limits>
+ParseResult BasicSerialParser<Limits>::handleCompletedLine(std::string_view rawLine)
 {
+    using namespace std::string_view_literals;
+
     auto result = ParseResult::Nothing; // default return value
-    const std::string line = trim(rawLine);
+    const std::string_view line = trim(rawLine);
+    constexpr auto DataPrefix = "DATA "sv;
 
     switch (state_)
     {
     case ParserState::Idle:
-        if (line == "BEGIN")
+        if (line == "BEGIN"sv)
         {
-            currentSeries_ = MeasurementSeries{};
+            currentSeries_.clear(); // keeps capacity, no allocation
+            ++seriesSequence_;
             state_ = ParserState::ReceivingSeries;
         }
         break;
 
     case ParserState::ReceivingSeries:
-        if (line.rfind("DATA ", 0) == 0)
+        if (line.substr(0, DataPrefix.size()) == DataPrefix)
         {
-            result = extractXYData(line.c_str() + 5); // skip "DATA "
+            result = extractXYData(line.substr(DataPrefix.size()));
             state_ = ParserState::ReceivingSeries;
         }
-        else if (line == "END")
+        else if (line == "END"sv)
         {
             if (!currentSeries_.empty())
                 result = ParseResult::SeriesCompleted;
             state_ = ParserState::Idle;
         }
-        else if (line == "BEGIN")
+        else if (line == "BEGIN"sv)
         {
             // Resync, discard incomplete series and start fresh
-            currentSeries_ = MeasurementSeries{};
+            currentSeries_.clear();
+            ++seriesSequence_;
             state_ = ParserState::ReceivingSeries;
         }
         break;
@@ -88,41 +199,117 @@ ParseResult SerialParser::handleCompletedLine(const std::string &rawLine)
 }
 
 // Extracts an XY data point and appends it to currentSeries_.
-ParseResult SerialParser::extractXYData(const char *data)
+template <typename Limits>
+ParseResult BasicSerialParser<Limits>::extractXYData(std::string_view data)
 {
-    // main() sets LC_NUMERIC to "C";
-    // '.' is guaranteed as decimal separator
-    char *end = nullptr;
-    double x = std::strtod(data, &end);
+    // Locale-independent, '.' is always the decimal separator
+    double x;
+    std::size_t n = parseDecimal(data, x);
 
-    if (end == data || *end != ' ')
+    if (n == 0 || n >= data.size() || data[n] != ' ')
         return ParseResult::ParseError;
-    if (x < VoltageRangeMin || x > VoltageRangeMax)
+    if (x < Limits::VoltageRangeMin || x > Limits::VoltageRangeMax)
         return ParseResult::ParseError;
 
-    data = end;
-    double y = std::strtod(data, &end);
+    data.remove_prefix(n);
+    double y;
+    n = parseDecimal(data, y);
 
-    if (end == data || *end != '\0')
+    if (n == 0 || n != data.size())
         return ParseResult::ParseError;
-    if (y < CurrentRangeMin || y > CurrentRangeMax)
+    if (y < Limits::CurrentRangeMin || y > Limits::CurrentRangeMax)
         return ParseResult::ParseError;
 
     // Series exceeds expected size
-    if (currentSeries_.size() >= MaxPointsCount)
+    if (currentSeries_.size() >= Limits::MaxPointsCount)
         return ParseResult::ParseError;
 
     currentSeries_.addPoint(x, y);
     return ParseResult::DataPointAdded;
 }
 
-// Returns a copy of s with leading and trailing whitespace removed.
-std::string SerialParser::trim(const std::string &s)
+// Parses a locale-independent decimal number ("[+-]digits[.digits]")
+// from the start of s, skipping leading whitespace like strtod().
+// Returns the number of characters consumed, or 0 on failure.
+template <typename Limits>
+std::size_t BasicSerialParser<Limits>::parseDecimal(std::string_view s, double &value) noexcept
+{
+    // Exact powers of ten; mantissa / Pow10[k] is correctly rounded
+    // as long as the mantissa fits into 53 bits (fixed-point output
+    // of the device such as "%.3f" is always well within that range)
+    static constexpr double Pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13,
+        1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    constexpr int MaxPow10 = static_cast<int>(sizeof(Pow10) / sizeof(Pow10[0])) - 1;
+    constexpr int MaxMantissaDigits = 19; // fits into uint64_t
+
+    std::size_t pos = s.find_first_not_of(" \t\n\v\f\r");
+    if (pos == std::string_view::npos)
+        return 0;
+
+    bool negative = false;
+    if (s[pos] == '+' || s[pos] == '-')
+        negative = (s[pos++] == '-');
+
+    std::uint64_t mantissa = 0;
+    int mantissaDigits = 0;
+    int exponent = 0;
+    bool anyDigit = false;
+
+    // Integer part; digits beyond the mantissa capacity only scale
+    for (; pos < s.size() && s[pos] >= '0' && s[pos] <= '9'; ++pos)
+    {
+        anyDigit = true;
+        if (mantissaDigits < MaxMantissaDigits)
+        {
+            mantissa = mantissa * 10 + static_cast<unsigned>(s[pos] - '0');
+            mantissaDigits += (mantissa != 0);
+        }
+        else
+        {
+            ++exponent;
+        }
+    }
+
+    // Fractional part; surplus digits are truncated
+    if (pos < s.size() && s[pos] == '.')
+    {
+        for (++pos; pos < s.size() && s[pos] >= '0' && s[pos] <= '9'; ++pos)
+        {
+            anyDigit = true;
+            if (mantissaDigits < MaxMantissaDigits)
+            {
+                mantissa = mantissa * 10 + static_cast<unsigned>(s[pos] - '0');
+                mantissaDigits += (mantissa != 0);
+                --exponent;
+            }
+        }
+    }
+
+    if (!anyDigit)
+        return 0;
+
+    double result = static_cast<double>(mantissa);
+    for (; exponent > 0; exponent -= std::min(exponent, MaxPow10))
+        result *= Pow10[std::min(exponent, MaxPow10)];
+    for (; exponent < 0; exponent += std::min(-exponent, MaxPow10))
+        result /= Pow10[std::min(-exponent, MaxPow10)];
+
+    value = negative ? -result : result;
+    return pos;
+}
+
+// Returns a view of s with leading and trailing whitespace removed.
+template <typename Limits>
+std::string_view BasicSerialParser<Limits>::trim(std::string_view s) noexcept
 {
     const auto first = s.find_first_not_of(" \t\n\r");
-    if (first == std::string::npos)
+    if (first == std::string_view::npos)
         return {};
 
     const auto last = s.find_last_not_of(" \t\n\r");
     return s.substr(first, last - first + 1);
 }
+
+// Parser variants provided by the core library.
+template class BasicSerialParser<StandardSerialLimits>;
+template class BasicSerialParser<HighResolutionSerialLimits>;
@@ -3,16 +3,26 @@
 //  It detects BEGIN/END blocks, parses DATA lines, and builds a
 //  MeasurementSeries from the incoming character stream.
 //
-//  - Call processReceivedChar() for each incoming character.
+//  - Call processReceivedChar() for each incoming character, or
+//    processReceivedChunk() for a whole block of received data.
 //  - When SeriesCompleted is returned, the current series
-//    contains a fully parsed measurement sequence.
+//    contains a fully parsed measurement sequence; take it over with
+//    releaseSeries() instead of copying it.
+//
+//  Protocol limits (point count, line length, value ranges) are a traits
+//  parameter of BasicSerialParser. SerialParser uses the limits of the
+//  firmware selected at build time (DIODESCOUT_HIGH_RESOLUTION_FIRMWARE).
 // ---------------------------------------------------------------------------
 
 #pragma once
 
 // Portable core module, no Qt dependencies.
 #include "coredatatypes.h"
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
 
 // ---------------------------------------------------------------------------
 //  ParseResult:
@@ -27,29 +37,107 @@ enum class ParseResult
 };
 
 // ---------------------------------------------------------------------------
-//  SerialParser:
-//  State-machine parser for the DiodeScout serial data format.
+//  ParseEvent:
+//  A non-trivial parse result reported by processReceivedChunk(), together
+//  with the offset of the causing character within the processed chunk.
 // ---------------------------------------------------------------------------
-class SerialParser
+struct ParseEvent
 {
-  private:
-    // Validation limits used while parsing input data.
+    ParseResult result;
+    std::size_t offset;
+
+    // Constructs a ParseEvent from a parse result and a chunk offset.
+    ParseEvent(ParseResult r, std::size_t off) noexcept :
+        result(r),
+        offset(off)
+    {
+    }
+};
+
+// ---------------------------------------------------------------------------
+//  StandardSerialLimits:
+//  Validation limits of the standard DiodeScout firmware.
+// ---------------------------------------------------------------------------
+struct StandardSerialLimits
+{
+    // Accepted voltage (V) and current (mA) ranges.
     static constexpr double VoltageRangeMin = 0.0;
     static constexpr double VoltageRangeMax = 50.0;
     static constexpr double CurrentRangeMin = 0.0;
     static constexpr double CurrentRangeMax = 50.0;
+
+    // Maximum number of points per series.
     static constexpr std::size_t MaxPointsCount = 100;
+
+    // Maximum length of a line (characters, without line ending).
     static constexpr std::size_t MaxLineLength = 100;
 
+    // Initial capacity of the series being received (points).
+    static constexpr std::size_t InitialPointCapacity = 100;
+};
+
+// ---------------------------------------------------------------------------
+//  HighResolutionSerialLimits:
+//  Validation limits of the upgraded firmware with 1000+ points per sweep.
+// ---------------------------------------------------------------------------
+struct HighResolutionSerialLimits : StandardSerialLimits
+{
+    static constexpr std::size_t MaxPointsCount = 4096;
+    static constexpr std::size_t InitialPointCapacity = 1024;
+};
+
+// Limits of the firmware the application is built for.
+#ifdef DIODESCOUT_HIGH_RESOLUTION_FIRMWARE
+using DefaultSerialLimits = HighResolutionSerialLimits;
+#else
+using DefaultSerialLimits = StandardSerialLimits;
+#endif
+
+// ---------------------------------------------------------------------------
+//  BasicSerialParser:
+//  State-machine parser for the DiodeScout serial data format, validating
+//  input against the given limits. Instantiated in serialparser.cpp for
+//  StandardSerialLimits and HighResolutionSerialLimits.
+// ---------------------------------------------------------------------------
+template <typename LimitsT = StandardSerialLimits>
+class BasicSerialParser
+{
   public:
+    // Validation limits used while parsing input data.
+    using Limits = LimitsT;
+
     // Returns a read-only reference to the current measurement series.
     // The series is parser-owned and may change as parsing continues.
     const MeasurementSeries &currentSeries() const noexcept;
 
+    // Moves the current series into series (call after SeriesCompleted).
+    // The parser continues with the former storage of series, cleared, so
+    // callers recycle a buffer instead of copying every completed series.
+    void releaseSeries(MeasurementSeries &series) noexcept;
+
+    // Returns true while a series is being received (between BEGIN and END).
+    bool receivingSeries() const noexcept;
+
+    // Returns a counter that is incremented whenever a new series starts
+    // (BEGIN), so callers can tell a restarted series from a continued one.
+    std::uint64_t seriesSequence() const noexcept;
+
     // Returns DataPointAdded when a DATA line is parsed, SeriesCompleted when
     // END is received, ParseError on invalid input, or Nothing otherwise.
     ParseResult processReceivedChar(char c);
 
+    // Processes a block of received characters and returns the events it
+    // produced (Nothing results are omitted). Processing stops right after
+    // a SeriesCompleted event so the caller can consume currentSeries();
+    // 'consumed' receives the number of characters processed. The returned
+    // list is parser-owned and valid until the next call.
+    const std::vector<ParseEvent> &processReceivedChunk(std::string_view chunk, std::size_t &consumed);
+
+    // Parses a locale-independent decimal number ("[+-]digits[.digits]")
+    // from the start of s, skipping leading whitespace like strtod().
+    // Returns the number of characters consumed, or 0 on failure.
+    static std::size_t parseDecimal(std::string_view s, double &value) noexcept;
+
   private:
     // Internal parser state.
     enum class ParserState
@@ -62,17 +150,29 @@ class SerialParser
     ParserState state_ = ParserState::Idle;
 
     // The series currently being received.
-    MeasurementSeries currentSeries_;
+    MeasurementSeries currentSeries_{Limits::InitialPointCapacity};
+
+    // Number of series started so far.
+    std::uint64_t seriesSequence_ = 0;
 
     // Buffer for the line currently being received.
     std::string lineBuffer_;
 
+    // Events reported by the latest processReceivedChunk() call.
+    std::vector<ParseEvent> chunkEvents_;
+
     // Processes a fully received line and updates the parser state.
-    ParseResult handleCompletedLine(const std::string &rawLine);
+    ParseResult handleCompletedLine(std::string_view rawLine);
 
     // Extracts an XY data point and appends it to currentSeries_.
-    ParseResult extractXYData(const char *data);
+    ParseResult extractXYData(std::string_view data);
 
-    // Returns a copy of s with leading and trailing whitespace removed.
-    static std::string trim(const std::string &s);
+    // Returns a view of s with leading and trailing whitespace removed.
+    static std::string_view trim(std::string_view s) noexcept;
 };
+
+extern template class BasicSerialParser<StandardSerialLimits>;
+extern template class BasicSerialParser<HighResolutionSerialLimits>;
+
+// Parser for the firmware the application is built for.
+using SerialParser = BasicSerialParser<DefaultSerialLimits>;
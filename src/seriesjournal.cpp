@@ -0,0 +1,431 @@
+// ---------------------------------------------------------------------------
+//  Crash-safe acquisition journal
+//
+//  Append-only log of the changes to the acquired measurement series, so
+//  the series of an interrupted run (crash, power loss) can be recovered
+//  on the next start. Producers only encode a record and queue it; a
+//  background thread writes the queued records and syncs them to disk in
+//  batches, so journaling never blocks parsing or the UI.
+//
+//  File layout (all integers little-endian):
+//  - 8 byte magic "DSJRNL01"
+//  - Records: uint32 type, uint32 payload length, uint32 CRC-32 of type
+//    and payload, payload
+//  - AppendSeries payload: uint32 point count n, uint32 reserved,
+//    float64 voltages[n], float64 currents[n]
+//  - RemoveLastSeries, RemoveAllSeries, Undo, Redo, ReplaceAllSeries:
+//    no payload
+//  - ReplaceAllSeries marks an opened session: the series it loaded are
+//    not journaled, but it is a history step like the session load
+//
+//  Recovery replays all records up to the first truncated or corrupt one
+//  (a torn write at the moment of the crash) on a MeasurementDataManager,
+//  so removals are undone and redone exactly as during acquisition.
+// ---------------------------------------------------------------------------
+
+// Portable core module, no Qt dependencies.
+#include "seriesjournal.h"
+#include "datamanager.h"
+#include "sessionfile.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// File identification and format version.
+static constexpr char JournalMagic[8] = {'D', 'S', 'J', 'R', 'N', 'L', '0', '1'};
+
+// Sizes of the fixed-size structures (bytes).
+static constexpr std::size_t RecordHeaderSize = 12;
+static constexpr std::size_t SeriesHeaderSize = 8;
+
+// Stores value as little-endian bytes.
+static void PutLE(unsigned char *dst, std::uint64_t value, std::size_t bytes)
+{
+    for (std::size_t i = 0; i < bytes; ++i)
+        dst[i] = static_cast<unsigned char>(value >> (8 * i));
+}
+
+// Loads a little-endian value.
+static std::uint64_t GetLE(const unsigned char *src, std::size_t bytes)
+{
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < bytes; ++i)
+        value |= static_cast<std::uint64_t>(src[i]) << (8 * i);
+    return value;
+}
+
+// Stores a double as little-endian binary64.
+static void PutDouble(unsigned char *dst, double value)
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    PutLE(dst, bits, 8);
+}
+
+// Loads a little-endian binary64 double.
+static double GetDouble(const unsigned char *src)
+{
+    const std::uint64_t bits = GetLE(src, 8);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// ---------------------------------------------------------------------------
+//  Continues a CRC-32 (IEEE 802.3) over size bytes. Start with crc = 0.
+// ---------------------------------------------------------------------------
+static std::uint32_t Crc32(std::uint32_t crc, const unsigned char *data, std::size_t size)
+{
+    static const auto table = []()
+    {
+        std::array<std::uint32_t, 256> t{};
+        for (std::uint32_t i = 0; i < 256; ++i)
+        {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    crc = ~crc;
+    for (std::size_t i = 0; i < size; ++i)
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+// Creates (or truncates) a file for unbuffered writing. Returns the file
+// descriptor, or -1 on failure.
+static int OpenForWrite(const std::string &filePath)
+{
+#ifdef _WIN32
+    return _open(filePath.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    return ::open(filePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+#endif
+}
+
+// Writes all bytes, retrying partial writes. Returns true on success.
+static bool WriteAll(int fd, const unsigned char *data, std::size_t size)
+{
+    while (size > 0)
+    {
+#ifdef _WIN32
+        const int n = _write(fd, data, static_cast<unsigned>(std::min<std::size_t>(size, 1u << 30)));
+#else
+        const ssize_t n = ::write(fd, data, size);
+        if (n < 0 && errno == EINTR)
+            continue;
+#endif
+        if (n <= 0)
+            return false;
+        data += n;
+        size -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+// Flushes written data to the storage device. Returns true on success.
+static bool SyncFile(int fd)
+{
+#ifdef _WIN32
+    return _commit(fd) == 0;
+#else
+    return ::fsync(fd) == 0;
+#endif
+}
+
+// Closes a file descriptor.
+static void CloseFile(int fd)
+{
+#ifdef _WIN32
+    _close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+// Closes the journal, see close().
+SeriesJournal::~SeriesJournal()
+{
+    close();
+}
+
+// Creates (or truncates) a journal file and starts the writer thread.
+// Returns true on success.
+bool SeriesJournal::open(const std::string &filePath)
+{
+    close();
+
+    fd_ = OpenForWrite(filePath);
+    if (fd_ < 0)
+        return false;
+
+    if (!WriteAll(fd_, reinterpret_cast<const unsigned char *>(JournalMagic), sizeof(JournalMagic)) ||
+        !SyncFile(fd_))
+    {
+        CloseFile(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    filePath_ = filePath;
+    stopRequested_ = false;
+    good_ = true;
+    writer_ = std::thread(&SeriesJournal::writeLoop, this);
+    return true;
+}
+
+// Returns true if a journal file is open.
+bool SeriesJournal::isOpen() const noexcept
+{
+    return fd_ >= 0;
+}
+
+// Returns false once a write or sync has failed.
+bool SeriesJournal::good() const
+{
+    return good_;
+}
+
+// Queues a completed series.
+void SeriesJournal::appendSeries(const MeasurementSeries &series)
+{
+    queueRecord(RecordType::AppendSeries, &series);
+}
+
+// Queues the removal of the most recently added series.
+void SeriesJournal::removeLastSeries()
+{
+    queueRecord(RecordType::RemoveLastSeries, nullptr);
+}
+
+// Queues the removal of all series.
+void SeriesJournal::removeAllSeries()
+{
+    queueRecord(RecordType::RemoveAllSeries, nullptr);
+}
+
+// Queues an undo of the most recent removal.
+void SeriesJournal::undo()
+{
+    queueRecord(RecordType::Undo, nullptr);
+}
+
+// Queues a redo of the most recently undone removal.
+void SeriesJournal::redo()
+{
+    queueRecord(RecordType::Redo, nullptr);
+}
+
+// Queues the replacement of all series by an opened session.
+void SeriesJournal::replaceAllSeries()
+{
+    queueRecord(RecordType::ReplaceAllSeries, nullptr);
+}
+
+// Writes and syncs all queued records, stops the writer thread and
+// closes the file. Returns true if all records were written.
+bool SeriesJournal::close()
+{
+    if (fd_ < 0)
+        return true;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopRequested_ = true;
+    }
+    wake_.notify_one();
+    writer_.join();
+
+    CloseFile(fd_);
+    fd_ = -1;
+    return good_;
+}
+
+// Closes the journal and deletes its file (clean shutdown).
+void SeriesJournal::discard()
+{
+    if (fd_ < 0)
+        return;
+
+    close();
+    std::remove(filePath_.c_str());
+}
+
+// Replays the journal file on manager.
+// Returns false if the file does not exist or is not a journal.
+bool SeriesJournal::Recover(const std::string &filePath, MeasurementDataManager &manager)
+{
+    MappedFile file;
+    if (!file.open(filePath) || file.size() < sizeof(JournalMagic) ||
+        std::memcmp(file.data(), JournalMagic, sizeof(JournalMagic)) != 0)
+        return false;
+
+    const unsigned char *p = file.data() + sizeof(JournalMagic);
+    const unsigned char *end = file.data() + file.size();
+    std::vector<double> voltages;
+    std::vector<double> currents;
+
+    // Stop at the first incomplete or corrupt record
+    while (static_cast<std::size_t>(end - p) >= RecordHeaderSize)
+    {
+        const auto type = static_cast<RecordType>(GetLE(p, 4));
+        const std::uint64_t size = GetLE(p + 4, 4);
+        const auto crc = static_cast<std::uint32_t>(GetLE(p + 8, 4));
+        const unsigned char *payload = p + RecordHeaderSize;
+        if (static_cast<std::uint64_t>(end - payload) < size || Crc32(Crc32(0, p, 4), payload, size) != crc)
+            break;
+
+        switch (type)
+        {
+        case RecordType::AppendSeries:
+        {
+            const std::uint64_t n = size >= SeriesHeaderSize ? GetLE(payload, 4) : 0;
+            if (size != SeriesHeaderSize + 16 * n)
+                return true; // valid checksum, but not written by this version
+
+            voltages.resize(static_cast<std::size_t>(n));
+            currents.resize(static_cast<std::size_t>(n));
+            const unsigned char *column = payload + SeriesHeaderSize;
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                voltages[k] = GetDouble(column + 8 * k);
+                currents[k] = GetDouble(column + 8 * (n + k));
+            }
+
+            MeasurementSeries series;
+            series.assign(voltages.data(), currents.data(), voltages.size());
+            manager.appendSeries(series);
+            break;
+        }
+
+        case RecordType::RemoveLastSeries:
+            manager.removeLastSeries();
+            break;
+
+        case RecordType::RemoveAllSeries:
+            manager.removeAllSeries();
+            break;
+
+        case RecordType::Undo:
+            manager.undo();
+            break;
+
+        case RecordType::Redo:
+            manager.redo();
+            break;
+
+        case RecordType::ReplaceAllSeries:
+            manager.replaceAllSeries({});
+            break;
+
+        default:
+            return true;
+        }
+
+        p = payload + size;
+    }
+
+    return true;
+}
+
+// Encodes a record into pending_ and wakes the writer.
+void SeriesJournal::queueRecord(RecordType type, const MeasurementSeries *series)
+{
+    if (fd_ < 0 || !good_)
+        return;
+
+    const std::size_t n = series ? series->size() : 0;
+    const std::size_t size = series ? SeriesHeaderSize + 16 * n : 0;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::size_t start = pending_.size();
+        pending_.resize(start + RecordHeaderSize + size);
+        unsigned char *record = pending_.data() + start;
+        unsigned char *payload = record + RecordHeaderSize;
+
+        if (series)
+        {
+            PutLE(payload, n, 4);
+            PutLE(payload + 4, 0, 4);
+            unsigned char *column = payload + SeriesHeaderSize;
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                PutDouble(column + 8 * k, series->voltages()[k]);
+                PutDouble(column + 8 * (n + k), series->currents()[k]);
+            }
+        }
+
+        PutLE(record, static_cast<std::uint32_t>(type), 4);
+        PutLE(record + 4, size, 4);
+        PutLE(record + 8, Crc32(Crc32(0, record, 4), payload, size), 4);
+    }
+
+    wake_.notify_one();
+}
+
+// Writer thread: writes queued records and syncs at most every
+// SyncInterval, and on shutdown.
+void SeriesJournal::writeLoop()
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<unsigned char> batch;
+    auto lastSync = Clock::now() - SyncInterval;
+    bool unsynced = false;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;)
+    {
+        // Sleep until records arrive, or until the pending sync is due
+        if (pending_.empty() && !stopRequested_)
+        {
+            if (unsynced)
+                wake_.wait_until(lock, lastSync + SyncInterval);
+            else
+                wake_.wait(lock);
+        }
+
+        batch.swap(pending_);
+        const bool stop = stopRequested_;
+        lock.unlock();
+
+        // After a failure the file ends in a torn record, drop the rest
+        bool ok = good_;
+        if (ok && !batch.empty())
+        {
+            ok = WriteAll(fd_, batch.data(), batch.size());
+            unsynced = true;
+        }
+        batch.clear();
+
+        const auto now = Clock::now();
+        if (ok && unsynced && (stop || now - lastSync >= SyncInterval))
+        {
+            ok = SyncFile(fd_);
+            lastSync = now;
+            unsynced = false;
+        }
+
+        if (!ok)
+            good_ = false;
+
+        lock.lock();
+        if (stop)
+            break;
+    }
+}
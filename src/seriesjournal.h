@@ -0,0 +1,144 @@
+// ---------------------------------------------------------------------------
+//  Crash-safe acquisition journal
+//
+//  Append-only log of the changes to the acquired measurement series, so
+//  the series of an interrupted run (crash, power loss) can be recovered
+//  on the next start. Producers only encode a record and queue it; a
+//  background thread writes the queued records and syncs them to disk in
+//  batches, so journaling never blocks parsing or the UI.
+//
+//  File layout (all integers little-endian):
+//  - 8 byte magic "DSJRNL01"
+//  - Records: uint32 type, uint32 payload length, uint32 CRC-32 of type
+//    and payload, payload
+//  - AppendSeries payload: uint32 point count n, uint32 reserved,
+//    float64 voltages[n], float64 currents[n]
+//  - RemoveLastSeries, RemoveAllSeries, Undo, Redo, ReplaceAllSeries:
+//    no payload
+//  - ReplaceAllSeries marks an opened session: the series it loaded are
+//    not journaled, but it is a history step like the session load
+//
+//  Recovery replays all records up to the first truncated or corrupt one
+//  (a torn write at the moment of the crash) on a MeasurementDataManager,
+//  so removals are undone and redone exactly as during acquisition.
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+// Portable core module, no Qt dependencies.
+#include "coredatatypes.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class MeasurementDataManager;
+
+// ---------------------------------------------------------------------------
+//  SeriesJournal:
+//  Asynchronous append-only journal of measurement series changes.
+// ---------------------------------------------------------------------------
+class SeriesJournal
+{
+  private:
+    // Maximum time records stay unsynced; bounds the data lost on power
+    // failure while batching syncs during high-rate acquisition.
+    static constexpr std::chrono::milliseconds SyncInterval{250};
+
+  public:
+    SeriesJournal() = default;
+    SeriesJournal(const SeriesJournal &) = delete;
+    SeriesJournal &operator=(const SeriesJournal &) = delete;
+
+    // Closes the journal, see close().
+    ~SeriesJournal();
+
+    // Creates (or truncates) a journal file and starts the writer thread.
+    // Returns true on success.
+    bool open(const std::string &filePath);
+
+    // Returns true if a journal file is open.
+    bool isOpen() const noexcept;
+
+    // Returns false once a write or sync has failed; later records are
+    // dropped. Safe to call from any thread.
+    bool good() const;
+
+    // Queues a completed series. Safe to call from any thread.
+    void appendSeries(const MeasurementSeries &series);
+
+    // Queues the removal of the most recently added series.
+    // Safe to call from any thread.
+    void removeLastSeries();
+
+    // Queues the removal of all series. Safe to call from any thread.
+    void removeAllSeries();
+
+    // Queues an undo of the most recent removal (see
+    // MeasurementDataManager::undo()). Safe to call from any thread.
+    void undo();
+
+    // Queues a redo of the most recently undone removal.
+    // Safe to call from any thread.
+    void redo();
+
+    // Queues the replacement of all series by an opened session (see
+    // MeasurementDataManager::loadSession()). The session's series are not
+    // journaled; recovery replaces the series by none, recording the same
+    // undoable step. Safe to call from any thread.
+    void replaceAllSeries();
+
+    // Writes and syncs all queued records, stops the writer thread and
+    // closes the file. Returns true if all records were written.
+    bool close();
+
+    // Closes the journal and deletes its file (clean shutdown).
+    void discard();
+
+    // Replays the journal file on manager (usually empty).
+    // Returns false if the file does not exist or is not a journal.
+    static bool Recover(const std::string &filePath, MeasurementDataManager &manager);
+
+  private:
+    // Record types.
+    enum class RecordType : std::uint32_t
+    {
+        AppendSeries = 1,
+        RemoveLastSeries = 2,
+        RemoveAllSeries = 3,
+        Undo = 4,
+        Redo = 5,
+        ReplaceAllSeries = 6
+    };
+
+    // Path of the open journal file.
+    std::string filePath_;
+
+    // File descriptor of the journal file (-1 if closed).
+    int fd_ = -1;
+
+    // Background writer.
+    std::thread writer_;
+
+    // Encoded records not yet written, guarded by mutex_.
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::vector<unsigned char> pending_;
+    bool stopRequested_ = false;
+
+    // Cleared on the first failed write or sync.
+    std::atomic<bool> good_{true};
+
+    // Encodes a record into pending_ and wakes the writer. The payload
+    // consists of the header and the two columns of series (if not null).
+    void queueRecord(RecordType type, const MeasurementSeries *series);
+
+    // Writer thread: writes queued records and syncs at most every
+    // SyncInterval, and on shutdown.
+    void writeLoop();
+};
@@ -0,0 +1,543 @@
+// ---------------------------------------------------------------------------
+//  Binary session files
+//
+//  Stores measurement series in a compact columnar format. Sessions are
+//  opened by memory-mapping the file: only the index is decoded on open,
+//  the sample data of a series is read when the series is accessed. Large
+//  sessions therefore open without parsing, in time independent of the
+//  number of points.
+//
+//  File layout (little-endian integers and IEEE 754 binary32 samples,
+//  all blocks 8-byte aligned):
+//  - 8 byte magic "DSSESS01"
+//  - Series blocks: uint32 point count n, uint32 tag "SER1",
+//    float32 voltages[n], float32 currents[n]
+//  - Index, per series: uint64 block offset, uint32 n, uint32 reserved,
+//    float32 min/max voltage, float32 min/max current
+//  - Metadata: uint32 entry count, entries of uint32 length + key bytes,
+//    uint32 length + value bytes, zero padding to 8 bytes
+//  - Trailer: uint64 index offset, uint64 series count, magic "DSINDX01"
+//
+//  SessionWriter appends and flushes one block per series, so sessions
+//  can be saved while they are acquired; index and trailer are written on
+//  close(). A file without a valid trailer (e.g. after a crash) is still
+//  readable, SessionReader then rebuilds the index from the series blocks.
+// ---------------------------------------------------------------------------
+
+// Portable core module, no Qt dependencies.
+#include "sessionfile.h"
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// File identification and format version.
+static constexpr char SessionMagic[8] = {'D', 'S', 'S', 'E', 'S', 'S', '0', '1'};
+static constexpr char TrailerMagic[8] = {'D', 'S', 'I', 'N', 'D', 'X', '0', '1'};
+
+// Tag of a series block ("SER1").
+static constexpr std::uint32_t BlockTag = 0x31524553;
+
+// Sizes of the fixed-size structures (bytes).
+static constexpr std::size_t BlockHeaderSize = 8;
+static constexpr std::size_t IndexEntrySize = 32;
+static constexpr std::size_t TrailerSize = 24;
+
+// Stores value as little-endian bytes.
+static void PutLE(unsigned char *dst, std::uint64_t value, std::size_t bytes)
+{
+    for (std::size_t i = 0; i < bytes; ++i)
+        dst[i] = static_cast<unsigned char>(value >> (8 * i));
+}
+
+// Loads a little-endian value.
+static std::uint64_t GetLE(const unsigned char *src, std::size_t bytes)
+{
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < bytes; ++i)
+        value |= static_cast<std::uint64_t>(src[i]) << (8 * i);
+    return value;
+}
+
+// Stores a float as little-endian binary32.
+static void PutFloat(unsigned char *dst, float value)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    PutLE(dst, bits, 4);
+}
+
+// Loads a little-endian binary32 float.
+static float GetFloat(const unsigned char *src)
+{
+    const auto bits = static_cast<std::uint32_t>(GetLE(src, 4));
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Returns true on little-endian hosts. Sample columns are used in place
+// from the mapping, which requires the file byte order.
+static bool HostIsLittleEndian()
+{
+    const std::uint32_t probe = 1;
+    unsigned char first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+// Returns the size of a series block with n points.
+static std::uint64_t BlockSize(std::uint64_t n)
+{
+    return BlockHeaderSize + 2 * 4 * n;
+}
+
+// Unmaps the file.
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+// Maps the file read-only. Returns true on success.
+bool MappedFile::open(const std::string &filePath)
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    void *view = nullptr;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+    {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping)
+        {
+            view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping); // the view keeps the mapping alive
+        }
+    }
+    CloseHandle(file);
+
+    if (!view)
+        return false;
+
+    data_ = static_cast<const unsigned char *>(view);
+    size_ = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+    const int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    void *view = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && st.st_size > 0)
+        view = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // the mapping stays valid
+
+    if (view == MAP_FAILED)
+        return false;
+
+    data_ = static_cast<const unsigned char *>(view);
+    size_ = static_cast<std::size_t>(st.st_size);
+#endif
+
+    return true;
+}
+
+// Unmaps the file.
+void MappedFile::close() noexcept
+{
+    if (!data_)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+#else
+    ::munmap(const_cast<unsigned char *>(data_), size_);
+#endif
+
+    data_ = nullptr;
+    size_ = 0;
+}
+
+// Returns the mapped bytes (null if not open).
+const unsigned char *MappedFile::data() const noexcept
+{
+    return data_;
+}
+
+// Returns the file size in bytes.
+std::size_t MappedFile::size() const noexcept
+{
+    return size_;
+}
+
+// Maps a session file and reads its index and metadata.
+// Returns true on success.
+bool SessionReader::open(const std::string &filePath)
+{
+    close();
+
+    if (!HostIsLittleEndian() || !file_.open(filePath))
+        return false;
+
+    if (file_.size() < sizeof(SessionMagic) || std::memcmp(file_.data(), SessionMagic, sizeof(SessionMagic)) != 0)
+    {
+        file_.close();
+        return false;
+    }
+
+    if (!readIndex() && !scanBlocks())
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+// Unmaps the session file.
+void SessionReader::close() noexcept
+{
+    file_.close();
+    index_.clear();
+    metadata_.clear();
+    recovered_ = false;
+    dataEnd_ = 0;
+}
+
+// Returns the number of stored series.
+std::size_t SessionReader::seriesCount() const noexcept
+{
+    return index_.size();
+}
+
+// Returns the index entry of the series with the given index.
+const SessionSeriesInfo &SessionReader::seriesInfo(std::size_t index) const noexcept
+{
+    return index_[index];
+}
+
+// Decodes the series with the given index.
+// Returns false if the series block is invalid.
+bool SessionReader::readSeries(std::size_t index, MeasurementSeries &series) const
+{
+    const SessionSeriesInfo &info = index_[index];
+    const std::uint64_t size = file_.size();
+    if (info.offset > size || BlockSize(info.pointCount) > size - info.offset)
+        return false;
+
+    const unsigned char *header = file_.data() + info.offset;
+    if (GetLE(header, 4) != info.pointCount || GetLE(header + 4, 4) != BlockTag)
+        return false;
+
+    const unsigned char *block = header + BlockHeaderSize;
+
+    // Blocks are 8-byte aligned, so the columns are valid float arrays
+    const auto *voltages = reinterpret_cast<const float *>(block);
+    const auto *currents = voltages + info.pointCount;
+    series.assign(voltages, currents, info.pointCount);
+    return true;
+}
+
+// Returns the session metadata.
+const SessionMetadata &SessionReader::metadata() const noexcept
+{
+    return metadata_;
+}
+
+// Returns true if the index was rebuilt from the series blocks.
+bool SessionReader::recovered() const noexcept
+{
+    return recovered_;
+}
+
+// Returns the end offset of the last series block.
+std::uint64_t SessionReader::dataEnd() const noexcept
+{
+    return dataEnd_;
+}
+
+// Reads index and metadata referenced by the trailer.
+// Returns false if the trailer or index is invalid.
+bool SessionReader::readIndex()
+{
+    const unsigned char *data = file_.data();
+    const std::uint64_t size = file_.size();
+    if (size < sizeof(SessionMagic) + TrailerSize)
+        return false;
+
+    const unsigned char *trailer = data + size - TrailerSize;
+    if (std::memcmp(trailer + 16, TrailerMagic, sizeof(TrailerMagic)) != 0)
+        return false;
+
+    const std::uint64_t indexOffset = GetLE(trailer, 8);
+    const std::uint64_t count = GetLE(trailer + 8, 8);
+    const std::uint64_t trailerOffset = size - TrailerSize;
+    if (indexOffset < sizeof(SessionMagic) || indexOffset > trailerOffset ||
+        count > (trailerOffset - indexOffset) / IndexEntrySize)
+        return false;
+
+    // Index entries, each referring to a complete block before the index
+    std::vector<SessionSeriesInfo> index(static_cast<std::size_t>(count));
+    const unsigned char *entry = data + indexOffset;
+    for (auto &info : index)
+    {
+        info.offset = GetLE(entry, 8);
+        info.pointCount = static_cast<std::size_t>(GetLE(entry + 8, 4));
+        info.bounds.minVoltage = GetFloat(entry + 16);
+        info.bounds.maxVoltage = GetFloat(entry + 20);
+        info.bounds.minCurrent = GetFloat(entry + 24);
+        info.bounds.maxCurrent = GetFloat(entry + 28);
+        entry += IndexEntrySize;
+
+        if (info.offset % 8 != 0 || info.offset < sizeof(SessionMagic) || info.offset > indexOffset ||
+            BlockSize(info.pointCount) > indexOffset - info.offset ||
+            GetLE(data + info.offset, 4) != info.pointCount || GetLE(data + info.offset + 4, 4) != BlockTag)
+            return false;
+    }
+
+    // Metadata entries
+    SessionMetadata metadata;
+    const unsigned char *end = data + trailerOffset;
+    auto readString = [&](std::string &s)
+    {
+        if (end - entry < 4)
+            return false;
+        const std::uint64_t length = GetLE(entry, 4);
+        entry += 4;
+        if (static_cast<std::uint64_t>(end - entry) < length)
+            return false;
+        s.assign(reinterpret_cast<const char *>(entry), static_cast<std::size_t>(length));
+        entry += length;
+        return true;
+    };
+
+    if (end - entry < 4)
+        return false;
+    std::uint64_t entries = GetLE(entry, 4);
+    entry += 4;
+    for (; entries > 0; --entries)
+    {
+        std::string key;
+        std::string value;
+        if (!readString(key) || !readString(value))
+            return false;
+        metadata[key] = std::move(value);
+    }
+
+    index_ = std::move(index);
+    metadata_ = std::move(metadata);
+    dataEnd_ = indexOffset;
+    return true;
+}
+
+// Rebuilds the index by walking the series blocks.
+// Returns false if no block was found after the magic.
+bool SessionReader::scanBlocks()
+{
+    const unsigned char *data = file_.data();
+    const std::uint64_t size = file_.size();
+    std::uint64_t offset = sizeof(SessionMagic);
+
+    recovered_ = true;
+    index_.clear();
+    metadata_.clear();
+
+    // Stops at the first incomplete block or at the remains of an index
+    while (size - offset >= BlockHeaderSize && GetLE(data + offset + 4, 4) == BlockTag)
+    {
+        SessionSeriesInfo info;
+        info.offset = offset;
+        info.pointCount = static_cast<std::size_t>(GetLE(data + offset, 4));
+        if (BlockSize(info.pointCount) > size - offset)
+            break;
+
+        MeasurementSeries series;
+        index_.push_back(info);
+        readSeries(index_.size() - 1, series);
+        index_.back().bounds = series.bounds();
+
+        offset += BlockSize(info.pointCount);
+    }
+
+    dataEnd_ = offset;
+
+    // A file of just the magic is an empty session, anything else must
+    // start with a complete block
+    return !index_.empty() || size == sizeof(SessionMagic);
+}
+
+// Finishes the session file, see close().
+SessionWriter::~SessionWriter()
+{
+    close();
+}
+
+// Creates (or truncates) a session file with the given metadata.
+// Returns true on success.
+bool SessionWriter::create(const std::string &filePath, const SessionMetadata &metadata)
+{
+    close();
+
+    out_.open(filePath, std::ios::binary | std::ios::trunc);
+    if (!out_)
+        return false;
+
+    index_.clear();
+    metadata_ = metadata;
+    out_.write(SessionMagic, sizeof(SessionMagic));
+    out_.flush();
+    offset_ = sizeof(SessionMagic);
+    return out_.good();
+}
+
+// Opens an existing session file to append further series.
+// Returns true on success.
+bool SessionWriter::openAppend(const std::string &filePath)
+{
+    close();
+
+    SessionReader reader;
+    if (!reader.open(filePath))
+        return false;
+
+    index_.clear();
+    index_.reserve(reader.seriesCount());
+    for (std::size_t i = 0; i < reader.seriesCount(); ++i)
+        index_.push_back(reader.seriesInfo(i));
+    metadata_ = reader.metadata();
+    offset_ = reader.dataEnd();
+    reader.close();
+
+    // Drop the old index, it is rewritten on close()
+    std::error_code error;
+    std::filesystem::resize_file(filePath, offset_, error);
+    if (error)
+    {
+        index_.clear();
+        return false;
+    }
+
+    out_.open(filePath, std::ios::binary | std::ios::app);
+    return out_.good();
+}
+
+// Returns true if a session file is open.
+bool SessionWriter::isOpen() const
+{
+    return out_.is_open();
+}
+
+// Appends a series block and flushes it to the file.
+// Returns true on success.
+bool SessionWriter::append(const MeasurementSeries &series)
+{
+    if (!out_.is_open())
+        return false;
+
+    const std::size_t n = series.size();
+    block_.resize(static_cast<std::size_t>(BlockSize(n)));
+    PutLE(block_.data(), n, 4);
+    PutLE(block_.data() + 4, BlockTag, 4);
+
+    unsigned char *voltages = block_.data() + BlockHeaderSize;
+    unsigned char *currents = voltages + 4 * n;
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        PutFloat(voltages + 4 * k, static_cast<float>(series.voltages()[k]));
+        PutFloat(currents + 4 * k, static_cast<float>(series.currents()[k]));
+    }
+
+    // Flush per series, so a crash loses at most the series being written
+    writeBytes(block_);
+    out_.flush();
+    if (!out_.good())
+        return false;
+
+    SessionSeriesInfo info;
+    info.offset = offset_ - block_.size();
+    info.pointCount = n;
+    info.bounds = series.bounds();
+    index_.push_back(info);
+    return true;
+}
+
+// Writes index, metadata and trailer and closes the file.
+// Returns true on success (also if no file was open).
+bool SessionWriter::close()
+{
+    if (!out_.is_open())
+        return true;
+
+    const std::uint64_t indexOffset = offset_;
+
+    // Index
+    block_.assign(index_.size() * IndexEntrySize, 0);
+    unsigned char *entry = block_.data();
+    for (const auto &info : index_)
+    {
+        PutLE(entry, info.offset, 8);
+        PutLE(entry + 8, info.pointCount, 4);
+        PutFloat(entry + 16, static_cast<float>(info.bounds.minVoltage));
+        PutFloat(entry + 20, static_cast<float>(info.bounds.maxVoltage));
+        PutFloat(entry + 24, static_cast<float>(info.bounds.minCurrent));
+        PutFloat(entry + 28, static_cast<float>(info.bounds.maxCurrent));
+        entry += IndexEntrySize;
+    }
+    writeBytes(block_);
+
+    // Metadata, padded so the trailer stays aligned
+    block_.assign(4, 0);
+    PutLE(block_.data(), metadata_.size(), 4);
+    auto appendString = [this](const std::string &s)
+    {
+        unsigned char length[4];
+        PutLE(length, s.size(), 4);
+        block_.insert(block_.end(), length, length + 4);
+        block_.insert(block_.end(), s.begin(), s.end());
+    };
+    for (const auto &[key, value] : metadata_)
+    {
+        appendString(key);
+        appendString(value);
+    }
+    block_.resize((block_.size() + 7) / 8 * 8, 0);
+    writeBytes(block_);
+
+    // Trailer
+    block_.assign(TrailerSize, 0);
+    PutLE(block_.data(), indexOffset, 8);
+    PutLE(block_.data() + 8, index_.size(), 8);
+    std::memcpy(block_.data() + 16, TrailerMagic, sizeof(TrailerMagic));
+    writeBytes(block_);
+
+    out_.close();
+    const bool ok = !out_.fail();
+    index_.clear();
+    metadata_.clear();
+    offset_ = 0;
+    return ok;
+}
+
+// Writes bytes at the end of the file.
+void SessionWriter::writeBytes(const std::vector<unsigned char> &bytes)
+{
+    out_.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    offset_ += bytes.size();
+}
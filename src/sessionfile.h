@@ -0,0 +1,197 @@
+// ---------------------------------------------------------------------------
+//  Binary session files
+//
+//  Stores measurement series in a compact columnar format. Sessions are
+//  opened by memory-mapping the file: only the index is decoded on open,
+//  the sample data of a series is read when the series is accessed. Large
+//  sessions therefore open without parsing, in time independent of the
+//  number of points.
+//
+//  File layout (little-endian integers and IEEE 754 binary32 samples,
+//  all blocks 8-byte aligned):
+//  - 8 byte magic "DSSESS01"
+//  - Series blocks: uint32 point count n, uint32 tag "SER1",
+//    float32 voltages[n], float32 currents[n]
+//  - Index, per series: uint64 block offset, uint32 n, uint32 reserved,
+//    float32 min/max voltage, float32 min/max current
+//  - Metadata: uint32 entry count, entries of uint32 length + key bytes,
+//    uint32 length + value bytes, zero padding to 8 bytes
+//  - Trailer: uint64 index offset, uint64 series count, magic "DSINDX01"
+//
+//  SessionWriter appends and flushes one block per series, so sessions
+//  can be saved while they are acquired; index and trailer are written on
+//  close(). A file without a valid trailer (e.g. after a crash) is still
+//  readable, SessionReader then rebuilds the index from the series blocks.
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+// Portable core module, no Qt dependencies.
+#include "coredatatypes.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+// Free-form session properties (e.g. data source), stored as UTF-8 text.
+using SessionMetadata = std::map<std::string, std::string>;
+
+// ---------------------------------------------------------------------------
+//  SessionSeriesInfo:
+//  Index entry of a stored series, available without reading its data.
+// ---------------------------------------------------------------------------
+struct SessionSeriesInfo
+{
+    std::uint64_t offset = 0;   // file offset of the series block
+    std::size_t pointCount = 0; // number of points
+    MeasurementBounds bounds;   // bounds of all points
+};
+
+// ---------------------------------------------------------------------------
+//  MappedFile:
+//  Read-only memory mapping of a whole file.
+// ---------------------------------------------------------------------------
+class MappedFile
+{
+  public:
+    MappedFile() = default;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // Unmaps the file.
+    ~MappedFile();
+
+    // Maps the file read-only. Returns true on success.
+    bool open(const std::string &filePath);
+
+    // Unmaps the file.
+    void close() noexcept;
+
+    // Returns the mapped bytes (null if not open).
+    const unsigned char *data() const noexcept;
+
+    // Returns the file size in bytes.
+    std::size_t size() const noexcept;
+
+  private:
+    // Start and size of the mapping.
+    const unsigned char *data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+// ---------------------------------------------------------------------------
+//  SessionReader:
+//  Provides random access to the series of a memory-mapped session file.
+// ---------------------------------------------------------------------------
+class SessionReader
+{
+  public:
+    // Maps a session file and reads its index and metadata.
+    // Returns true on success; fails if the file has neither a valid
+    // index nor a readable series block (other than an empty session).
+    bool open(const std::string &filePath);
+
+    // Unmaps the session file.
+    void close() noexcept;
+
+    // Returns the number of stored series.
+    std::size_t seriesCount() const noexcept;
+
+    // Returns the index entry of the series with the given index
+    // (index < seriesCount()).
+    const SessionSeriesInfo &seriesInfo(std::size_t index) const noexcept;
+
+    // Decodes the series with the given index (index < seriesCount()).
+    // Safe to call concurrently for different target series. Returns
+    // false, leaving series unchanged, if the series block is invalid.
+    bool readSeries(std::size_t index, MeasurementSeries &series) const;
+
+    // Returns the session metadata.
+    const SessionMetadata &metadata() const noexcept;
+
+    // Returns true if the file had no valid index and it was rebuilt
+    // from the series blocks (e.g. after a crash while saving).
+    bool recovered() const noexcept;
+
+    // Returns the end offset of the last series block.
+    std::uint64_t dataEnd() const noexcept;
+
+  private:
+    // Mapping of the session file.
+    MappedFile file_;
+
+    // Index entries of all series, in file order.
+    std::vector<SessionSeriesInfo> index_;
+
+    // Session metadata.
+    SessionMetadata metadata_;
+
+    // True if the index was rebuilt from the series blocks.
+    bool recovered_ = false;
+
+    // End offset of the last series block.
+    std::uint64_t dataEnd_ = 0;
+
+    // Reads index and metadata referenced by the trailer.
+    // Returns false if the trailer or index is invalid.
+    bool readIndex();
+
+    // Rebuilds the index by walking the series blocks. Returns false if
+    // no block was found although the file holds data after the magic.
+    bool scanBlocks();
+};
+
+// ---------------------------------------------------------------------------
+//  SessionWriter:
+//  Appends series to a session file.
+// ---------------------------------------------------------------------------
+class SessionWriter
+{
+  public:
+    SessionWriter() = default;
+    SessionWriter(const SessionWriter &) = delete;
+    SessionWriter &operator=(const SessionWriter &) = delete;
+
+    // Finishes the session file, see close().
+    ~SessionWriter();
+
+    // Creates (or truncates) a session file with the given metadata.
+    // Returns true on success.
+    bool create(const std::string &filePath, const SessionMetadata &metadata = {});
+
+    // Opens an existing session file to append further series; its
+    // series and metadata are kept. Returns true on success.
+    bool openAppend(const std::string &filePath);
+
+    // Returns true if a session file is open.
+    bool isOpen() const;
+
+    // Appends a series block and flushes it to the file.
+    // Returns true on success.
+    bool append(const MeasurementSeries &series);
+
+    // Writes index, metadata and trailer and closes the file.
+    // Returns true on success (also if no file was open).
+    bool close();
+
+  private:
+    // Output file.
+    std::ofstream out_;
+
+    // Index entries of all series written so far.
+    std::vector<SessionSeriesInfo> index_;
+
+    // Metadata written on close().
+    SessionMetadata metadata_;
+
+    // Current end of the file.
+    std::uint64_t offset_ = 0;
+
+    // Scratch buffer for one encoded series block.
+    std::vector<unsigned char> block_;
+
+    // Writes bytes at the end of the file.
+    void writeBytes(const std::vector<unsigned char> &bytes);
+};
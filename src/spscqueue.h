@@ -0,0 +1,87 @@
+// ---------------------------------------------------------------------------
+//  Lock-free single-producer/single-consumer queue
+//
+//  Bounded ring buffer used to hand completed measurement series from the
+//  acquisition thread to the GUI thread without locking. Exactly one thread
+//  may push and exactly one (other) thread may pop.
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+// Portable core module, no Qt dependencies.
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+//  SpscQueue:
+//  Bounded lock-free single-producer/single-consumer queue.
+// ---------------------------------------------------------------------------
+template <typename T>
+class SpscQueue
+{
+  private:
+    // Separates producer and consumer indices to avoid false sharing.
+    static constexpr std::size_t CacheLineSize = 64;
+
+  public:
+    // Constructs a queue holding at least 'capacity' elements
+    // (rounded up to the next power of two).
+    explicit SpscQueue(std::size_t capacity) :
+        slots_(roundUpToPowerOfTwo(capacity)),
+        mask_(slots_.size() - 1)
+    {
+    }
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    // Moves item into the queue. Producer thread only.
+    // Returns false (leaving item untouched) if the queue is full.
+    bool tryPush(T &&item)
+    {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) > mask_)
+            return false;
+
+        slots_[tail & mask_] = std::move(item);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Moves the oldest element into item. Consumer thread only.
+    // Returns false if the queue is empty.
+    bool tryPop(T &item)
+    {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+            return false;
+
+        item = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+  private:
+    // Element storage, size is a power of two.
+    std::vector<T> slots_;
+
+    // Index mask (size - 1).
+    const std::size_t mask_;
+
+    // Next slot to read, written by the consumer only.
+    alignas(CacheLineSize) std::atomic<std::size_t> head_{0};
+
+    // Next slot to write, written by the producer only.
+    alignas(CacheLineSize) std::atomic<std::size_t> tail_{0};
+
+    // Returns the smallest power of two >= n (at least 1).
+    static std::size_t roundUpToPowerOfTwo(std::size_t n) noexcept
+    {
+        std::size_t p = 1;
+        while (p < n)
+            p <<= 1;
+        return p;
+    }
+};
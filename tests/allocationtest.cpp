@@ -0,0 +1,221 @@
+// ---------------------------------------------------------------------------
+//  Allocation test for the SerialParser hot path.
+//
+//  Replaces the global operator new with a counting version and checks
+//  that, once warmed up, the parser processes BEGIN/DATA/END streams
+//  (including malformed lines and the hand-off of completed series into
+//  a recycled buffer) without any heap allocation. A separate executable,
+//  as the replacement applies to the whole program.
+//
+//  Usage: diodescout_allocationtest
+// ---------------------------------------------------------------------------
+
+#include "serialparser.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <string_view>
+
+// Allocations made while counting is enabled.
+static std::atomic<std::size_t> AllocationCount{0};
+static std::atomic<bool> CountingEnabled{false};
+
+// Allocates size bytes with the given alignment, counting the allocation.
+static void *CountedAllocate(std::size_t size, std::size_t alignment)
+{
+    if (CountingEnabled.load(std::memory_order_relaxed))
+        AllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (size == 0)
+        size = 1;
+
+    void *p = nullptr;
+    if (alignment <= alignof(std::max_align_t))
+        p = std::malloc(size);
+    else
+        p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+// ---------------------------------------------------------------------------
+//  Replacements of the global allocation functions.
+// ---------------------------------------------------------------------------
+void *operator new(std::size_t size)
+{
+    return CountedAllocate(size, alignof(std::max_align_t));
+}
+
+void *operator new[](std::size_t size)
+{
+    return CountedAllocate(size, alignof(std::max_align_t));
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    return CountedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return CountedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    try
+    {
+        return CountedAllocate(size, alignof(std::max_align_t));
+    }
+    catch (const std::bad_alloc &)
+    {
+        return nullptr;
+    }
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept
+{
+    std::free(p);
+}
+
+// ---------------------------------------------------------------------------
+//  Returns a DiodeScout byte stream of seriesCount series with
+//  pointsPerSeries points each and some malformed lines.
+// ---------------------------------------------------------------------------
+static std::string MakeStream(int seriesCount, int pointsPerSeries)
+{
+    std::string stream;
+    char line[64];
+    for (int s = 0; s < seriesCount; ++s)
+    {
+        stream += "BEGIN\r\n";
+        for (int p = 0; p < pointsPerSeries; ++p)
+        {
+            std::snprintf(line, sizeof(line), "DATA %.3f %.3f\r\n", 0.01 * p, 0.1 * p * (s + 1));
+            stream += line;
+        }
+        stream += "DATA 0.5x 1.0\r\n";
+        stream += "  DATA 1.0\r\n";
+        stream += "END\r\n";
+    }
+    return stream;
+}
+
+// ---------------------------------------------------------------------------
+//  Feeds stream through the parser in chunks of chunkSize characters.
+//  Completed series are swapped out into handOff when it is given.
+//  Returns the number of completed series.
+// ---------------------------------------------------------------------------
+static std::size_t ParseStream(SerialParser &parser, std::string_view stream, std::size_t chunkSize,
+    MeasurementSeries *handOff)
+{
+    std::size_t completed = 0;
+    for (std::size_t start = 0; start < stream.size(); start += chunkSize)
+    {
+        std::string_view chunk = stream.substr(start, chunkSize);
+        while (!chunk.empty())
+        {
+            std::size_t consumed = 0;
+            for (const ParseEvent &event : parser.processReceivedChunk(chunk, consumed))
+            {
+                if (event.result != ParseResult::SeriesCompleted)
+                    continue;
+                ++completed;
+                if (handOff)
+                    parser.releaseSeries(*handOff);
+            }
+            chunk.remove_prefix(consumed);
+        }
+    }
+    return completed;
+}
+
+// ---------------------------------------------------------------------------
+//  Application entry point.
+// ---------------------------------------------------------------------------
+int main()
+{
+    constexpr int SeriesCount = 20;
+    const std::string stream = MakeStream(SeriesCount, static_cast<int>(DefaultSerialLimits::MaxPointsCount));
+
+    int failures = 0;
+    for (bool handOff : {false, true})
+    {
+        for (std::size_t chunkSize : {std::size_t{1}, std::size_t{61}, std::size_t{4096}})
+        {
+            SerialParser parser;
+            MeasurementSeries recycled;
+            MeasurementSeries *target = handOff ? &recycled : nullptr;
+
+            // Warm-up grows the line buffer, event list and series columns
+            ParseStream(parser, stream, chunkSize, target);
+
+            AllocationCount = 0;
+            CountingEnabled = true;
+            const std::size_t completed = ParseStream(parser, stream, chunkSize, target);
+            CountingEnabled = false;
+
+            const bool passed = AllocationCount == 0 && completed == SeriesCount;
+            std::fprintf(stderr, "%s parser/%s/chunk-%zu: %zu allocations, %zu series\n", passed ? "PASS" : "FAIL",
+                handOff ? "handoff" : "inplace", chunkSize, AllocationCount.load(), completed);
+            if (!passed)
+                ++failures;
+        }
+    }
+
+    return failures;
+}
@@ -0,0 +1,869 @@
+// ---------------------------------------------------------------------------
+//  Unit tests for the DiodeScout core library.
+//
+//  Self-contained test runner without external dependencies. Links only
+//  diodescout_core, so it runs on machines without Qt (e.g. CI). Failed
+//  checks are reported on stderr; the exit code is the number of failed
+//  tests.
+//
+//  - SerialParser: chunked processing matches per-character processing
+//  - MeasurementBounds of points, series and the data manager
+//  - Undo/redo of removals and session loads
+//  - Binary session round trip and recovery of truncated sessions
+//  - Series journal recovery, also of a torn last record and of series
+//    acquired after opening a session
+//  - ColumnKernels at every instruction set level against scalar loops
+//  - IncrementalPWLFitter against the full piecewise-linear fit
+//  - Shockley fits recover the parameters of generated series
+//  - SerialParser::parseDecimal() against strtod()
+//  - DecimateSeries() point selection and budget
+//  - SamplePool block reuse and release of empty chunks
+//  - BasicSerialParser limits of the high-resolution firmware
+//  - LambertWExp() and DiodeModel currents for large negative arguments
+//
+//  Usage: diodescout_tests
+// ---------------------------------------------------------------------------
+
+#include "columnkernels.h"
+#include "datamanager.h"
+#include "decimation.h"
+#include "diodefit.h"
+#include "diodemodel.h"
+#include "ivgenerator.h"
+#include "pwlfitter.h"
+#include "samplepool.h"
+#include "serialparser.h"
+#include "seriesjournal.h"
+#include "sessionfile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+// Failed checks of the running test.
+static int CheckFailures = 0;
+
+// Records a failed check with its location.
+#define CHECK(condition)                                                                                         \
+    do                                                                                                           \
+    {                                                                                                            \
+        if (!(condition))                                                                                        \
+        {                                                                                                        \
+            std::fprintf(stderr, "  %s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);              \
+            ++CheckFailures;                                                                                     \
+        }                                                                                                        \
+    } while (false)
+
+// ---------------------------------------------------------------------------
+//  ScratchFile:
+//  Path of a file in the temporary directory, deleted on destruction.
+// ---------------------------------------------------------------------------
+class ScratchFile
+{
+  public:
+    // Constructs the path of a scratch file with the given name.
+    explicit ScratchFile(const char *name) :
+        path_((std::filesystem::temp_directory_path() / name).string())
+    {
+        remove();
+    }
+
+    ScratchFile(const ScratchFile &) = delete;
+    ScratchFile &operator=(const ScratchFile &) = delete;
+
+    // Deletes the file.
+    ~ScratchFile()
+    {
+        remove();
+    }
+
+    // Returns the file path.
+    const std::string &path() const noexcept
+    {
+        return path_;
+    }
+
+    // Returns the file size in bytes.
+    std::uintmax_t size() const
+    {
+        return std::filesystem::file_size(path_);
+    }
+
+    // Truncates the file to size bytes.
+    void truncate(std::uintmax_t size) const
+    {
+        std::filesystem::resize_file(path_, size);
+    }
+
+  private:
+    // File path.
+    std::string path_;
+
+    // Deletes the file if it exists.
+    void remove() const noexcept
+    {
+        std::error_code error;
+        std::filesystem::remove(path_, error);
+    }
+};
+
+// ---------------------------------------------------------------------------
+//  Returns a series with n points on a straight line (exactly
+//  representable in single precision).
+// ---------------------------------------------------------------------------
+static MeasurementSeries MakeSeries(std::size_t n, double slope)
+{
+    MeasurementSeries series;
+    for (std::size_t k = 0; k < n; ++k)
+        series.addPoint(0.125 * static_cast<double>(k), slope * static_cast<double>(k));
+    return series;
+}
+
+// ---------------------------------------------------------------------------
+//  Returns true if both series hold the same points.
+// ---------------------------------------------------------------------------
+static bool SameSeries(const MeasurementSeries &a, const MeasurementSeries &b)
+{
+    return a.voltages() == b.voltages() && a.currents() == b.currents();
+}
+
+// ---------------------------------------------------------------------------
+//  Returns a DiodeScout byte stream of generated series, with a malformed
+//  line every corruptEvery lines (0 = none).
+// ---------------------------------------------------------------------------
+static std::string MakeStream(int seriesCount, int corruptEvery)
+{
+    IVGeneratorSettings settings = IVGeneratorSettings::SiliconDiode();
+    settings.pointsPerSeries = 60;
+    IVGenerator generator(settings);
+    MeasurementSeries series;
+
+    std::string stream;
+    char line[64];
+    int lineCount = 0;
+    auto appendLine = [&](const char *text)
+    {
+        ++lineCount;
+        stream += (corruptEvery > 0 && lineCount % corruptEvery == 0) ? "DATA 0.5x 1.0" : text;
+        stream += "\r\n";
+    };
+
+    for (int s = 0; s < seriesCount; ++s)
+    {
+        generator.generate(series);
+        appendLine("BEGIN");
+        for (std::size_t p = 0; p < series.size(); ++p)
+        {
+            std::snprintf(line, sizeof(line), "DATA %.3f %.3f", series.voltages()[p], series.currents()[p]);
+            appendLine(line);
+        }
+        appendLine("END");
+    }
+
+    return stream;
+}
+
+// ---------------------------------------------------------------------------
+//  Parse results and completed series produced from a stream.
+// ---------------------------------------------------------------------------
+struct ParseTrace
+{
+    std::vector<std::pair<ParseResult, std::size_t>> events; // result, stream offset
+    std::vector<MeasurementSeries> series;
+};
+
+// Parses stream one character at a time.
+static ParseTrace ParsePerChar(std::string_view stream)
+{
+    SerialParser parser;
+    ParseTrace trace;
+    for (std::size_t k = 0; k < stream.size(); ++k)
+    {
+        const ParseResult result = parser.processReceivedChar(stream[k]);
+        if (result == ParseResult::Nothing)
+            continue;
+        trace.events.emplace_back(result, k);
+        if (result == ParseResult::SeriesCompleted)
+            trace.series.push_back(parser.currentSeries());
+    }
+    return trace;
+}
+
+// Parses stream in chunks of chunkSize characters.
+static ParseTrace ParseChunked(std::string_view stream, std::size_t chunkSize)
+{
+    SerialParser parser;
+    ParseTrace trace;
+    for (std::size_t start = 0; start < stream.size(); start += chunkSize)
+    {
+        std::string_view chunk = stream.substr(start, chunkSize);
+        std::size_t chunkOffset = start;
+        while (!chunk.empty())
+        {
+            std::size_t consumed = 0;
+            for (const ParseEvent &event : parser.processReceivedChunk(chunk, consumed))
+            {
+                trace.events.emplace_back(event.result, chunkOffset + event.offset);
+                if (event.result == ParseResult::SeriesCompleted)
+                {
+                    MeasurementSeries series;
+                    parser.releaseSeries(series);
+                    trace.series.push_back(std::move(series));
+                }
+            }
+            chunk.remove_prefix(consumed);
+            chunkOffset += consumed;
+        }
+    }
+    return trace;
+}
+
+// ---------------------------------------------------------------------------
+//  Tests.
+// ---------------------------------------------------------------------------
+
+// Chunked parsing reports the same events and series as per-character
+// parsing, independent of the chunk boundaries.
+static void TestParserChunkMatchesPerChar()
+{
+    for (int corruptEvery : {0, 17})
+    {
+        const std::string stream = MakeStream(5, corruptEvery);
+        const ParseTrace expected = ParsePerChar(stream);
+        CHECK(!expected.series.empty());
+        if (corruptEvery == 0)
+            CHECK(expected.series.size() == 5);
+
+        for (std::size_t chunkSize : {std::size_t{1}, std::size_t{7}, std::size_t{64}, stream.size()})
+        {
+            const ParseTrace actual = ParseChunked(stream, chunkSize);
+            CHECK(actual.events == expected.events);
+            CHECK(actual.series.size() == expected.series.size());
+            for (std::size_t i = 0; i < actual.series.size() && i < expected.series.size(); ++i)
+                CHECK(SameSeries(actual.series[i], expected.series[i]));
+        }
+    }
+}
+
+// Bounds cover all included points, series and stored series.
+static void TestMeasurementBounds()
+{
+    MeasurementBounds empty;
+    CHECK(empty.minVoltage > empty.maxVoltage);
+    CHECK(empty.minCurrent > empty.maxCurrent);
+
+    MeasurementBounds bounds;
+    bounds.include(0.5, 2.0);
+    bounds.include(-0.25, 4.0);
+    CHECK(bounds.minVoltage == -0.25 && bounds.maxVoltage == 0.5);
+    CHECK(bounds.minCurrent == 2.0 && bounds.maxCurrent == 4.0);
+
+    bounds.include(empty);
+    CHECK(bounds.minVoltage == -0.25 && bounds.maxCurrent == 4.0);
+
+    const MeasurementSeries series = MakeSeries(9, 2.0);
+    CHECK(series.bounds().minVoltage == 0.0 && series.bounds().maxVoltage == 1.0);
+    CHECK(series.bounds().minCurrent == 0.0 && series.bounds().maxCurrent == 16.0);
+
+    MeasurementDataManager manager;
+    manager.appendSeries(MakeSeries(9, 2.0));
+    manager.appendSeries(MakeSeries(5, 8.0));
+    CHECK(manager.maxVoltage() == 1.0);
+    CHECK(manager.maxCurrent() == 32.0);
+
+    // Removing the series with the largest current shrinks the bounds
+    manager.removeLastSeries();
+    CHECK(manager.maxCurrent() == 16.0);
+    manager.undo();
+    CHECK(manager.maxCurrent() == 32.0);
+}
+
+// Removals and session loads are undone and redone without losing series.
+static void TestUndoRedo()
+{
+    MeasurementDataManager manager;
+    CHECK(!manager.canUndo() && !manager.canRedo());
+    CHECK(!manager.removeLastSeries());
+    CHECK(!manager.canUndo());
+
+    for (std::size_t k = 1; k <= 3; ++k)
+        manager.appendSeries(MakeSeries(4, static_cast<double>(k)));
+
+    CHECK(manager.removeLastSeries());
+    CHECK(manager.seriesCount() == 2);
+    CHECK(manager.undo());
+    CHECK(manager.seriesCount() == 3);
+    CHECK(SameSeries(manager.allSeries().back(), MakeSeries(4, 3.0)));
+    CHECK(manager.redo());
+    CHECK(manager.seriesCount() == 2);
+
+    CHECK(manager.removeAllSeries());
+    CHECK(manager.seriesCount() == 0);
+
+    // Removals from an empty collection record no step, so the next undo
+    // restores the series removed above
+    CHECK(!manager.removeAllSeries());
+    CHECK(!manager.removeLastSeries());
+    CHECK(manager.undo());
+    CHECK(manager.seriesCount() == 2);
+    CHECK(SameSeries(manager.allSeries()[1], MakeSeries(4, 2.0)));
+
+    // Series appended after a removal are kept by its undo and redo
+    CHECK(manager.removeLastSeries());
+    manager.appendSeries(MakeSeries(4, 9.0));
+    CHECK(manager.undo());
+    CHECK(manager.seriesCount() == 3);
+    CHECK(manager.redo());
+    CHECK(manager.seriesCount() == 2);
+    CHECK(SameSeries(manager.allSeries().back(), MakeSeries(4, 9.0)));
+
+    // History is bounded, the oldest steps are dropped
+    MeasurementDataManager bounded;
+    for (int k = 0; k < 100; ++k)
+    {
+        bounded.appendSeries(MakeSeries(2, 1.0));
+        bounded.removeLastSeries();
+    }
+    int undone = 0;
+    while (bounded.undo())
+        ++undone;
+    CHECK(undone > 0 && undone < 100);
+}
+
+// Saved sessions load with all points and metadata; truncated sessions
+// recover all complete series.
+static void TestSessionRoundTrip()
+{
+    ScratchFile file("diodescout_tests_session.dss");
+
+    MeasurementDataManager manager;
+    for (std::size_t k = 1; k <= 4; ++k)
+        manager.appendSeries(MakeSeries(10 * k, static_cast<double>(k)));
+    CHECK(manager.saveSession(file.path(), {{"source", "tests"}}));
+
+    SessionReader reader;
+    CHECK(reader.open(file.path()));
+    CHECK(!reader.recovered());
+    CHECK(reader.seriesCount() == 4);
+    CHECK(reader.metadata().count("source") == 1 && reader.metadata().at("source") == "tests");
+    reader.close();
+
+    MeasurementDataManager loaded;
+    loaded.appendSeries(MakeSeries(3, 1.0));
+    CHECK(loaded.loadSession(file.path()));
+    CHECK(loaded.seriesCount() == 4);
+    for (std::size_t k = 0; k < loaded.seriesCount() && k < 4; ++k)
+        CHECK(SameSeries(loaded.allSeries()[k], manager.allSeries()[k]));
+    CHECK(loaded.undo());
+    CHECK(loaded.seriesCount() == 1);
+
+    // Cut into the last series block: the first three series remain
+    SessionWriter writer;
+    CHECK(writer.create(file.path()));
+    for (const auto &series : manager.allSeries())
+        CHECK(writer.append(series));
+    const std::uintmax_t withoutIndex = file.size();
+    CHECK(writer.close());
+    file.truncate(withoutIndex - 4);
+
+    CHECK(reader.open(file.path()));
+    CHECK(reader.recovered());
+    CHECK(reader.seriesCount() == 3);
+    MeasurementSeries series;
+    for (std::size_t k = 0; k < reader.seriesCount(); ++k)
+    {
+        CHECK(reader.readSeries(k, series));
+        CHECK(SameSeries(series, manager.allSeries()[k]));
+    }
+    reader.close();
+
+    // A header followed by garbage is not a session
+    file.truncate(8);
+    CHECK(reader.open(file.path()));
+    CHECK(reader.seriesCount() == 0);
+    reader.close();
+    file.truncate(20);
+    CHECK(!reader.open(file.path()));
+    CHECK(!loaded.loadSession(file.path()));
+    CHECK(loaded.seriesCount() == 1);
+}
+
+// Replaying a journal restores the series and the effect of removals,
+// undo and redo; a torn last record is ignored.
+static void TestJournalRecovery()
+{
+    ScratchFile file("diodescout_tests_journal.dsj");
+
+    SeriesJournal journal;
+    CHECK(journal.open(file.path()));
+    for (std::size_t k = 1; k <= 3; ++k)
+        journal.appendSeries(MakeSeries(5, static_cast<double>(k)));
+    journal.removeLastSeries();
+    journal.undo();
+    journal.removeLastSeries();
+    journal.appendSeries(MakeSeries(7, 5.0));
+    CHECK(journal.close());
+    CHECK(journal.good());
+
+    MeasurementDataManager manager;
+    CHECK(SeriesJournal::Recover(file.path(), manager));
+    CHECK(manager.seriesCount() == 3);
+    if (manager.seriesCount() == 3)
+    {
+        CHECK(SameSeries(manager.allSeries()[1], MakeSeries(5, 2.0)));
+        CHECK(SameSeries(manager.allSeries()[2], MakeSeries(7, 5.0)));
+    }
+
+    // The series of the torn last record is lost, all others remain
+    file.truncate(file.size() - 3);
+    MeasurementDataManager torn;
+    CHECK(SeriesJournal::Recover(file.path(), torn));
+    CHECK(torn.seriesCount() == 2);
+
+    MeasurementDataManager missing;
+    CHECK(!SeriesJournal::Recover(file.path() + ".missing", missing));
+
+    // Opening a session into an empty window, then acquiring and undoing,
+    // recovers the collection that was on screen: the session load is a
+    // step of its own, so the undo does not reach the earlier removal
+    ScratchFile session("diodescout_tests_journal_session.dss");
+    MeasurementDataManager saved;
+    saved.appendSeries(MakeSeries(4, 6.0));
+    saved.appendSeries(MakeSeries(4, 7.0));
+    CHECK(saved.saveSession(session.path()));
+
+    MeasurementDataManager live;
+    SeriesJournal sessionJournal;
+    CHECK(sessionJournal.open(file.path()));
+    live.appendSeries(MakeSeries(3, 1.0));
+    sessionJournal.appendSeries(live.allSeries().back());
+    CHECK(live.removeLastSeries());
+    sessionJournal.removeLastSeries();
+    CHECK(live.loadSession(session.path()));
+    sessionJournal.replaceAllSeries();
+    live.appendSeries(MakeSeries(3, 8.0));
+    sessionJournal.appendSeries(live.allSeries().back());
+    CHECK(live.undo());
+    sessionJournal.undo();
+    CHECK(sessionJournal.close());
+
+    MeasurementDataManager recovered;
+    CHECK(SeriesJournal::Recover(file.path(), recovered));
+    CHECK(live.seriesCount() == 1);
+    CHECK(recovered.seriesCount() == live.seriesCount());
+    if (recovered.seriesCount() == 1 && live.seriesCount() == 1)
+        CHECK(SameSeries(recovered.allSeries()[0], live.allSeries()[0]));
+    CHECK(recovered.canUndo() == live.canUndo() && recovered.canRedo() == live.canRedo());
+}
+
+// ---------------------------------------------------------------------------
+//  Returns true if a and b agree within the relative tolerance (or an
+//  absolute one of the same size near zero).
+// ---------------------------------------------------------------------------
+static bool Near(double a, double b, double tolerance)
+{
+    return std::abs(a - b) <= tolerance * std::max({1.0, std::abs(a), std::abs(b)});
+}
+
+// Column kernels give the results of plain scalar loops at every
+// instruction set level, also for lengths with a partial last vector.
+static void TestColumnKernels()
+{
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> uniform(-5.0, 5.0);
+    std::vector<double> x(203);
+    std::vector<double> y(x.size());
+    for (std::size_t k = 0; k < x.size(); ++k)
+    {
+        x[k] = uniform(random);
+        y[k] = uniform(random);
+    }
+
+    const ColumnKernels::Level defaultLevel = ColumnKernels::level();
+    for (auto level : {ColumnKernels::Level::Scalar, ColumnKernels::Level::SSE2, ColumnKernels::Level::AVX2})
+    {
+        if (level > ColumnKernels::supportedLevel())
+            continue;
+        ColumnKernels::setLevel(level);
+        CHECK(ColumnKernels::level() == level);
+
+        for (std::size_t n : {std::size_t{0}, std::size_t{1}, std::size_t{3}, std::size_t{5}, std::size_t{8},
+                 std::size_t{127}, x.size()})
+        {
+            double expectedMin = std::numeric_limits<double>::infinity();
+            double expectedMax = -std::numeric_limits<double>::infinity();
+            double expectedDot = 0.0;
+            RegressionSums expected;
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                expectedMin = std::min(expectedMin, x[k]);
+                expectedMax = std::max(expectedMax, x[k]);
+                expectedDot += x[k] * y[k];
+                if (x[k] >= 0.5)
+                {
+                    ++expected.count;
+                    expected.sumX += x[k];
+                    expected.sumY += y[k];
+                    expected.sumXY += x[k] * y[k];
+                    expected.sumXX += x[k] * x[k];
+                }
+            }
+
+            double minValue = 0.0;
+            double maxValue = 0.0;
+            ColumnKernels::minMax(x.data(), n, minValue, maxValue);
+            CHECK(minValue == expectedMin && maxValue == expectedMax);
+            CHECK(Near(ColumnKernels::dot(x.data(), y.data(), n), expectedDot, 1e-12));
+
+            // Vector lanes sum in a different order, so allow rounding
+            const RegressionSums sums = ColumnKernels::maskedRegressionSums(x.data(), y.data(), n, 0.5);
+            CHECK(sums.count == expected.count);
+            CHECK(Near(sums.sumX, expected.sumX, 1e-12) && Near(sums.sumY, expected.sumY, 1e-12));
+            CHECK(Near(sums.sumXY, expected.sumXY, 1e-12) && Near(sums.sumXX, expected.sumXX, 1e-12));
+        }
+    }
+    ColumnKernels::setLevel(defaultLevel);
+}
+
+// The incremental piecewise-linear fit, fed point by point, gives the
+// model of a full fit over the same points at every step.
+static void TestIncrementalPWLFitter()
+{
+    IVGeneratorSettings settings = IVGeneratorSettings::SiliconDiode();
+    settings.pointsPerSeries = 80;
+    settings.parameterSpread = 0.05;
+    settings.voltageNoise = 0.002;
+    settings.currentNoise = 0.01;
+    IVGenerator generator(settings);
+
+    MeasurementSeries series;
+    IncrementalPWLFitter fitter;
+    for (int s = 0; s < 5; ++s)
+    {
+        generator.generate(series);
+        fitter.reset();
+
+        for (std::size_t k = 0; k < series.size(); ++k)
+        {
+            fitter.addPoint(series.voltages()[k], series.currents()[k]);
+            CHECK(fitter.pointCount() == k + 1);
+
+            // Full fit over the first k + 1 points
+            MeasurementSeries head;
+            head.assign(series.voltages().data(), series.currents().data(), k + 1);
+            MeasurementDataManager prefix;
+            prefix.appendSeries(std::move(head));
+
+            PWLModel expected;
+            expected.valid = prefix.computePWL(expected.forwardV, expected.seriesR);
+            const PWLModel actual = fitter.model();
+            CHECK(actual.valid == expected.valid);
+            if (actual.valid && expected.valid)
+                CHECK(Near(actual.forwardV, expected.forwardV, 1e-9) && Near(actual.seriesR, expected.seriesR, 1e-9));
+        }
+        CHECK(fitter.model().valid);
+    }
+}
+
+// Shockley fits recover the parameters of noise-free generated series,
+// also when computed for many series in parallel.
+static void TestShockleyFit()
+{
+    MeasurementDataManager manager;
+    for (IVGeneratorSettings settings : {IVGeneratorSettings::SiliconDiode(), IVGeneratorSettings::RedLED()})
+    {
+        settings.pointsPerSeries = 100;
+        settings.voltageResolution = 0.0;
+        settings.currentResolution = 0.0;
+        IVGenerator generator(settings);
+        MeasurementSeries series;
+        generator.generate(series);
+
+        ShockleyFit fit;
+        fit.model.temperature = settings.model.temperature;
+        CHECK(FitShockleyModel(series, fit));
+        CHECK(fit.valid);
+        CHECK(Near(fit.model.saturationCurrent / settings.model.saturationCurrent, 1.0, 1e-3));
+        CHECK(Near(fit.model.idealityFactor, settings.model.idealityFactor, 1e-4));
+        CHECK(Near(fit.model.seriesResistance, settings.model.seriesResistance, 1e-3));
+
+        for (int k = 0; k < 8; ++k)
+            manager.appendSeries(series);
+    }
+
+    // Enough series to be split over threads
+    const std::vector<ShockleyFit> fits = manager.computeAllShockley(DiodeModel::RoomTemperature, 4);
+    CHECK(fits.size() == manager.seriesCount());
+    for (std::size_t i = 0; i < fits.size() && i < manager.seriesCount(); ++i)
+    {
+        ShockleyFit expected;
+        expected.model.temperature = DiodeModel::RoomTemperature;
+        FitShockleyModel(manager.allSeries()[i], expected);
+        CHECK(fits[i].valid == expected.valid);
+        CHECK(fits[i].model.saturationCurrent == expected.model.saturationCurrent);
+        CHECK(fits[i].model.idealityFactor == expected.model.idealityFactor);
+        CHECK(fits[i].model.seriesResistance == expected.model.seriesResistance);
+    }
+}
+
+// parseDecimal() gives the value and length strtod() parses from
+// fixed-point input and rejects input without digits.
+static void TestParseDecimal()
+{
+    auto matchesStrtod = [](const char *text)
+    {
+        double value = 0.0;
+        const std::size_t consumed = SerialParser::parseDecimal(text, value);
+        char *end = nullptr;
+        const double expected = std::strtod(text, &end);
+        return consumed == static_cast<std::size_t>(end - text) && value == expected;
+    };
+
+    std::mt19937 random(11);
+    std::uniform_int_distribution<int> digits(0, 9);
+    std::uniform_int_distribution<int> integerDigits(1, 7);
+    std::uniform_int_distribution<int> fractionDigits(0, 6);
+    char text[64];
+    for (int k = 0; k < 20000; ++k)
+    {
+        std::string number = (k % 3 == 0) ? "-" : (k % 3 == 1) ? "+" : "";
+        for (int d = integerDigits(random); d > 0; --d)
+            number += static_cast<char>('0' + digits(random));
+        if (const int fraction = fractionDigits(random); fraction > 0 || k % 2 == 0)
+        {
+            number += '.';
+            for (int d = fraction; d > 0; --d)
+                number += static_cast<char>('0' + digits(random));
+        }
+        CHECK(matchesStrtod(number.c_str()));
+
+        // As sent by the device
+        std::snprintf(text, sizeof(text), "%.3f", std::ldexp(static_cast<double>(random()), -22));
+        CHECK(matchesStrtod(text));
+    }
+
+    for (const char *valid : {"0", "-0.0", ".5", "5.", "007.250", "  12.25", "\t1.5 2.5", "1.5x",
+             "12345678901234567890.5"})
+        CHECK(matchesStrtod(valid));
+
+    // Exponents are not part of the device format
+    double value = 0.0;
+    CHECK(SerialParser::parseDecimal("1e5", value) == 1 && value == 1.0);
+
+    for (const char *malformed : {"", "   ", "+", "-", ".", "+.", "-.x", "abc", "x1", "- 1", "\r\n"})
+        CHECK(SerialParser::parseDecimal(malformed, value) == 0);
+}
+
+// Decimation keeps the ends of the covered range, returns ascending
+// indices and stays within the requested number of points.
+static void TestDecimation()
+{
+    IVGeneratorSettings settings = IVGeneratorSettings::SiliconDiode();
+    settings.pointsPerSeries = 5000;
+    settings.currentNoise = 0.01;
+    IVGenerator generator(settings);
+    MeasurementSeries series;
+    generator.generate(series);
+
+    const MeasurementBounds all = series.bounds();
+    MeasurementBounds zoomed;
+    zoomed.include(all.maxVoltage * 0.5, all.minCurrent);
+    zoomed.include(all.maxVoltage * 0.8, all.maxCurrent);
+
+    std::vector<std::size_t> indices;
+    for (const MeasurementBounds &view : {all, zoomed})
+    {
+        for (std::size_t maxPoints : {std::size_t{0}, std::size_t{3}, std::size_t{10}, std::size_t{640},
+                 std::size_t{10000}})
+        {
+            DecimateSeries(series, view, maxPoints, indices);
+            CHECK(!indices.empty());
+            CHECK(indices.size() <= std::max<std::size_t>(maxPoints, 3));
+            CHECK(std::is_sorted(indices.begin(), indices.end()));
+            CHECK(std::adjacent_find(indices.begin(), indices.end()) == indices.end());
+            CHECK(indices.back() < series.size());
+        }
+    }
+
+    // The whole series is covered from its first to its last point
+    DecimateSeries(series, all, 100, indices);
+    CHECK(indices.front() == 0 && indices.back() == series.size() - 1);
+    DecimateSeries(series, all, series.size(), indices);
+    CHECK(indices.size() == series.size());
+
+    // A zoomed view is covered up to one point beyond each edge
+    DecimateSeries(series, zoomed, 100, indices);
+    const auto &v = series.voltages();
+    CHECK(v[indices.front()] <= zoomed.minVoltage && v[indices.front() + 1] >= zoomed.minVoltage);
+    CHECK(v[indices.back()] >= zoomed.maxVoltage && v[indices.back() - 1] <= zoomed.maxVoltage);
+
+    DecimateSeries(MeasurementSeries(), all, 100, indices);
+    CHECK(indices.empty());
+}
+
+// The sample pool reuses released blocks and returns chunks without
+// allocated blocks to the heap, keeping chunks still in use.
+static void TestSamplePool()
+{
+    // Released blocks are handed out again
+    void *block = SamplePool::allocate(200);
+    CHECK(reinterpret_cast<std::uintptr_t>(block) % SamplePool::Alignment == 0);
+    SamplePool::deallocate(block, 200);
+    void *reused = SamplePool::allocate(193);
+    CHECK(reused == block);
+    SamplePool::deallocate(reused, 193);
+
+    // Blocks of the largest size class, several chunks worth
+    constexpr std::size_t BlockSize = SamplePool::MaxBlockSize;
+    constexpr std::size_t ChunkCount = 4;
+    std::vector<void *> blocks(ChunkCount * SamplePool::ChunkSize / BlockSize);
+    const std::size_t reservedBefore = SamplePool::reservedBytes();
+    for (void *&b : blocks)
+        b = SamplePool::allocate(BlockSize);
+    const std::size_t reservedFull = SamplePool::reservedBytes();
+    CHECK(reservedFull >= reservedBefore + (ChunkCount - 1) * SamplePool::ChunkSize);
+
+    // One live block keeps its chunk
+    void *kept = blocks.front();
+    std::memset(kept, 0x5a, BlockSize);
+    for (std::size_t k = 1; k < blocks.size(); ++k)
+        SamplePool::deallocate(blocks[k], BlockSize);
+
+    const std::size_t released = SamplePool::releaseUnused();
+    CHECK(released >= (ChunkCount - 2) * SamplePool::ChunkSize);
+    CHECK(SamplePool::reservedBytes() == reservedFull - released);
+    CHECK(static_cast<unsigned char *>(kept)[BlockSize - 1] == 0x5a);
+
+    // The pool keeps serving blocks after releasing chunks
+    for (void *&b : blocks)
+        b = SamplePool::allocate(BlockSize);
+    for (void *b : blocks)
+        SamplePool::deallocate(b, BlockSize);
+    SamplePool::deallocate(kept, BlockSize);
+    CHECK(SamplePool::releaseUnused() > 0);
+    CHECK(SamplePool::releaseUnused() == 0);
+}
+
+// Feeds stream to a parser with the given limits one character at a time,
+// counting the parse errors and returning the completed series.
+template <typename Limits>
+static std::vector<MeasurementSeries> ParseWithLimits(std::string_view stream, std::size_t &errors)
+{
+    BasicSerialParser<Limits> parser;
+    std::vector<MeasurementSeries> completed;
+    errors = 0;
+    for (char c : stream)
+    {
+        const ParseResult result = parser.processReceivedChar(c);
+        if (result == ParseResult::ParseError)
+            ++errors;
+        else if (result == ParseResult::SeriesCompleted)
+            completed.push_back(parser.currentSeries());
+    }
+    return completed;
+}
+
+// A 1000-point sweep of the upgraded firmware is accepted with the
+// high-resolution limits and truncated with the standard ones.
+static void TestParserHighResolution()
+{
+    constexpr std::size_t PointCount = 1000;
+    std::string stream = "BEGIN\r\n";
+    char line[64];
+    for (std::size_t p = 0; p < PointCount; ++p)
+    {
+        std::snprintf(line, sizeof(line), "DATA %.3f %.4f\r\n", 0.001 * p, 0.04 * p);
+        stream += line;
+    }
+    stream += "END\r\n";
+
+    std::size_t errors = 0;
+    std::vector<MeasurementSeries> series = ParseWithLimits<HighResolutionSerialLimits>(stream, errors);
+    CHECK(errors == 0);
+    CHECK(series.size() == 1);
+    if (series.size() == 1)
+    {
+        CHECK(series[0].size() == PointCount);
+        CHECK(Near(series[0].voltages().back(), 0.001 * (PointCount - 1), 1e-12));
+    }
+
+    series = ParseWithLimits<StandardSerialLimits>(stream, errors);
+    CHECK(errors == PointCount - StandardSerialLimits::MaxPointsCount);
+    CHECK(series.size() == 1);
+    if (series.size() == 1)
+        CHECK(series[0].size() == StandardSerialLimits::MaxPointsCount);
+}
+
+// LambertWExp() stays finite for large negative arguments, where exp()
+// underflows, and the model gives the reverse current -Is there.
+static void TestLambertWExpNegative()
+{
+    for (double x : {-30.0, -100.0, -745.0, -800.0, -1e6})
+    {
+        const double w = LambertWExp(x);
+        CHECK(std::isfinite(w) && w >= 0.0);
+        CHECK(std::abs(w - std::exp(x)) <= 1e-12 * std::exp(x));
+    }
+    // Continuous across the switch to the series expansion
+    CHECK(Near(LambertWExp(-20.0 - 1e-9), LambertWExp(-20.0 + 1e-9), 1e-17));
+
+    const DiodeModel model;
+    for (double voltage : {-1.0, -20.0, -1000.0})
+    {
+        const double current = model.current(voltage);
+        CHECK(std::isfinite(current) && Near(current, -model.saturationCurrent, 1e-12));
+        CHECK(std::isfinite(model.currentThroughLoad(voltage, 1000.0)));
+    }
+}
+
+// ---------------------------------------------------------------------------
+//  Application entry point.
+// ---------------------------------------------------------------------------
+int main()
+{
+    struct Test
+    {
+        const char *name;
+        void (*run)();
+    };
+
+    const Test tests[] = {
+        {"parser/chunk-matches-per-char", TestParserChunkMatchesPerChar},
+        {"bounds", TestMeasurementBounds},
+        {"datamanager/undo-redo", TestUndoRedo},
+        {"session/round-trip", TestSessionRoundTrip},
+        {"journal/recovery", TestJournalRecovery},
+        {"kernels/reference", TestColumnKernels},
+        {"pwl/incremental-matches-full", TestIncrementalPWLFitter},
+        {"shockley/recovers-parameters", TestShockleyFit},
+        {"parser/parse-decimal", TestParseDecimal},
+        {"render/decimation", TestDecimation},
+        {"storage/sample-pool", TestSamplePool},
+        {"parser/high-resolution", TestParserHighResolution},
+        {"shockley/lambert-w-negative", TestLambertWExpNegative},
+    };
+
+    int failedTests = 0;
+    for (const Test &test : tests)
+    {
+        CheckFailures = 0;
+        test.run();
+        std::fprintf(stderr, "%s %s\n", CheckFailures == 0 ? "PASS" : "FAIL", test.name);
+        if (CheckFailures > 0)
+            ++failedTests;
+    }
+
+    std::fprintf(stderr, "%d of %zu tests failed.\n", failedTests, std::size(tests));
+    return failedTests;
+}
@@ -0,0 +1,251 @@
+// ---------------------------------------------------------------------------
+//  Headless command-line acquisition tool for the DiodeScout device.
+//
+//  Opens the DiodeScout serial port (auto-detected or given on the command
+//  line) with the same settings as the desktop application, streams the
+//  received data through the SerialParser and writes completed series via
+//  the MeasurementDataManager. Intended for unattended, scripted runs on
+//  machines without a display.
+//
+//  - CSV output is appended as soon as each series completes
+//  - --session appends each completed series to a binary session file
+//  - The Python script is written when acquisition ends; only then are
+//    series kept in memory, so long runs use constant memory otherwise
+//  - --record captures the raw byte stream, --replay feeds a capture
+//    through the same path instead of a device (e.g. for load tests)
+//  - Acquisition ends after --count series, on SIGINT/SIGTERM, at the
+//    end of a replay or when the serial port fails
+// ---------------------------------------------------------------------------
+
+#include "acquisitionworker.h"
+#include "datamanager.h"
+#include "replaydevice.h"
+#include "serialconnector.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QTimer>
+#include <clocale>
+#include <csignal>
+#include <cstdio>
+
+// Set by the signal handler, polled by the event loop.
+static volatile std::sig_atomic_t StopRequested = 0;
+
+// ---------------------------------------------------------------------------
+//  Requests a clean shutdown on SIGINT/SIGTERM.
+// ---------------------------------------------------------------------------
+static void OnStopSignal(int)
+{
+    StopRequested = 1;
+}
+
+// ---------------------------------------------------------------------------
+//  Application entry point.
+// ---------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    constexpr int StopPollInterval = 100; // ms
+
+    QCoreApplication application(argc, argv);
+    QCoreApplication::setApplicationName("DiodeScoutCLI");
+
+    // Force locale-independent decimal separator ('.'),
+    // required by the MeasurementDataManager export functions
+    std::setlocale(LC_NUMERIC, "C");
+
+    // Command line
+    QCommandLineParser cmd;
+    cmd.setApplicationDescription("Headless acquisition tool for the DiodeScout device.");
+    cmd.addHelpOption();
+
+    const QCommandLineOption portOpt({"p", "port"}, "Serial port name or path (default: auto-detect).", "port");
+    const QCommandLineOption csvOpt({"c", "csv"}, "Append each completed series to a CSV file.", "file");
+    const QCommandLineOption germanOpt("csv-comma", "Use ',' as decimal and ';' as field separator in CSV.");
+    const QCommandLineOption pythonOpt({"y", "python"}, "Write a Python script when acquisition ends.", "file");
+    const QCommandLineOption sessionOpt({"s", "session"}, "Append each completed series to a session file.", "file");
+    const QCommandLineOption countOpt({"n", "count"}, "Stop after N series (default: unlimited).", "N", "0");
+    const QCommandLineOption recordOpt("record", "Record the received raw data to a capture file.", "file");
+    const QCommandLineOption replayOpt("replay", "Replay a capture file instead of using a device.", "file");
+    const QCommandLineOption speedOpt("speed", "Replay speed factor, 0 = as fast as possible.", "factor", "1");
+    cmd.addOptions({portOpt, csvOpt, germanOpt, pythonOpt, sessionOpt, countOpt, recordOpt, replayOpt, speedOpt});
+    cmd.process(application);
+
+    const std::string csvPath = cmd.value(csvOpt).toStdString();
+    const std::string pythonPath = cmd.value(pythonOpt).toStdString();
+    const std::string sessionPath = cmd.value(sessionOpt).toStdString();
+    const bool germanStyle = cmd.isSet(germanOpt);
+    const CSVSettings csv(germanStyle ? ',' : '.', germanStyle ? ';' : ',');
+
+    bool countOk = false;
+    const qulonglong maxSeries = cmd.value(countOpt).toULongLong(&countOk);
+    if (!countOk)
+    {
+        std::fprintf(stderr, "Invalid series count: %s\n", qPrintable(cmd.value(countOpt)));
+        return EXIT_FAILURE;
+    }
+
+    QSerialPort diodeScoutPort;
+    ReplayDevice replayDevice;
+    QIODevice *dataSource = &diodeScoutPort;
+    QString sourceName;
+
+    if (cmd.isSet(replayOpt))
+    {
+        // Replay a previously recorded capture
+        bool speedOk = false;
+        const double speed = cmd.value(speedOpt).toDouble(&speedOk);
+        if (!speedOk || !replayDevice.openCapture(cmd.value(replayOpt), speed))
+        {
+            std::fprintf(stderr, "Cannot replay %s\n", qPrintable(cmd.value(replayOpt)));
+            return EXIT_FAILURE;
+        }
+
+        dataSource = &replayDevice;
+        sourceName = cmd.value(replayOpt);
+    }
+    else
+    {
+        // Establish DiodeScout serial connection
+        sourceName = cmd.value(portOpt);
+        if (sourceName.isEmpty())
+        {
+            QSerialPortInfo detected;
+            if (!DiodeScoutSerialConnector::Detect(detected))
+            {
+                std::fprintf(stderr, "No DiodeScout device detected, use --port to select one.\n");
+                return EXIT_FAILURE;
+            }
+            sourceName = detected.portName();
+        }
+
+        if (!DiodeScoutSerialConnector::Open(diodeScoutPort, sourceName))
+        {
+            std::fprintf(stderr, "Cannot open %s: %s\n", qPrintable(sourceName),
+                qPrintable(diodeScoutPort.errorString()));
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Start with an empty CSV file, series are appended as they complete
+    MeasurementDataManager dataManager;
+    if (!csvPath.empty() && !dataManager.exportCSV(csvPath, csv))
+    {
+        std::fprintf(stderr, "Cannot write %s\n", csvPath.c_str());
+        return EXIT_FAILURE;
+    }
+
+    // Series are flushed to the session file as they complete, the index
+    // is written when acquisition ends
+    SessionWriter sessionWriter;
+    const SessionMetadata sessionMetadata = {
+        {"source", sourceName.toStdString()},
+        {"created", QDateTime::currentDateTimeUtc().toString(Qt::ISODate).toStdString()},
+    };
+    if (!sessionPath.empty() && !sessionWriter.create(sessionPath, sessionMetadata))
+    {
+        std::fprintf(stderr, "Cannot write %s\n", sessionPath.c_str());
+        return EXIT_FAILURE;
+    }
+
+    // No GUI to keep responsive, the worker runs on the main thread
+    AcquisitionWorker worker(*dataSource);
+    int exitCode = EXIT_SUCCESS;
+
+    if (cmd.isSet(recordOpt) && !worker.startRecording(cmd.value(recordOpt).toStdString()))
+    {
+        std::fprintf(stderr, "Cannot write %s\n", qPrintable(cmd.value(recordOpt)));
+        return EXIT_FAILURE;
+    }
+
+    // Number of series acquired so far
+    std::size_t seriesCount = 0;
+
+    QObject::connect(&worker, &AcquisitionWorker::seriesAvailable, &application,
+        [&]()
+        {
+            MeasurementSeries series;
+            PWLModel pwl;
+            while (worker.takeCompletedSeries(series, pwl))
+            {
+                ++seriesCount;
+                if (pwl.valid)
+                    std::fprintf(stderr, "Series %zu: %zu points, Vf = %.2f V, Rs = %.2f Ohm\n", seriesCount,
+                        series.size(), pwl.forwardV, pwl.seriesR);
+                else
+                    std::fprintf(stderr, "Series %zu: %zu points\n", seriesCount, series.size());
+
+                if (!csvPath.empty() && !dataManager.appendSeriesCSV(csvPath, series, seriesCount, csv))
+                {
+                    std::fprintf(stderr, "Cannot write %s\n", csvPath.c_str());
+                    exitCode = EXIT_FAILURE;
+                    application.quit();
+                    return;
+                }
+
+                if (sessionWriter.isOpen() && !sessionWriter.append(series))
+                {
+                    std::fprintf(stderr, "Cannot write %s\n", sessionPath.c_str());
+                    exitCode = EXIT_FAILURE;
+                    application.quit();
+                    return;
+                }
+
+                // Only the Python script needs all series at the end
+                if (!pythonPath.empty())
+                    dataManager.appendSeries(std::move(series));
+
+                if (maxSeries > 0 && seriesCount >= maxSeries)
+                {
+                    application.quit();
+                    return;
+                }
+            }
+        });
+
+    QObject::connect(&diodeScoutPort, &QSerialPort::errorOccurred, &application,
+        [&](QSerialPort::SerialPortError error)
+        {
+            // e.g. device unplugged
+            if (error == QSerialPort::ResourceError)
+            {
+                std::fprintf(stderr, "Serial port error: %s\n", qPrintable(diodeScoutPort.errorString()));
+                exitCode = EXIT_FAILURE;
+                application.quit();
+            }
+        });
+
+    // All captured data has been delivered and parsed
+    QObject::connect(&replayDevice, &QIODevice::readChannelFinished, &application, &QCoreApplication::quit);
+
+    // Signal handlers must not touch Qt, so the event loop polls the flag
+    std::signal(SIGINT, OnStopSignal);
+    std::signal(SIGTERM, OnStopSignal);
+
+    QTimer stopPoll;
+    QObject::connect(&stopPoll, &QTimer::timeout, &application,
+        [&]()
+        {
+            if (StopRequested)
+                application.quit();
+        });
+    stopPoll.start(StopPollInterval);
+
+    std::fprintf(stderr, "Acquiring from %s, press Ctrl+C to stop.\n", qPrintable(sourceName));
+    application.exec();
+
+    if (!pythonPath.empty() && !dataManager.exportPython(pythonPath))
+    {
+        std::fprintf(stderr, "Cannot write %s\n", pythonPath.c_str());
+        exitCode = EXIT_FAILURE;
+    }
+
+    if (!sessionWriter.close())
+    {
+        std::fprintf(stderr, "Cannot write %s\n", sessionPath.c_str());
+        exitCode = EXIT_FAILURE;
+    }
+
+    std::fprintf(stderr, "%zu series acquired.\n", seriesCount);
+    return exitCode;
+}
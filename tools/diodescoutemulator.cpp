@@ -0,0 +1,369 @@
+// ---------------------------------------------------------------------------
+//  Pseudo-terminal based DiodeScout device emulator (UNIX only).
+//
+//  Creates a pseudo terminal and streams measurement sweeps over it using
+//  the DiodeScout BEGIN/DATA/END line protocol. The slave side behaves like
+//  a serial device, so DiodeScoutUI and DiodeScoutCLI can open it with
+//  --port (or any other DiodeScoutSerialConnector::Open() caller) and run
+//  the complete serial I/O and parser path without hardware.
+//
+//  - Sweeps are synthesized by the IVGenerator (silicon diode or LED)
+//  - Sweep rate, point count, device spread and noise are configurable;
+//    more than 100 points per sweep emulate the high-resolution firmware
+//  - Every N-th line can be replaced by malformed input
+//  - --rate 0 streams as fast as the reader consumes the data
+//  - Statistics are printed on exit (end of --count or SIGINT/SIGTERM)
+//
+//  Usage: DiodeScoutEmulator [options], see --help
+// ---------------------------------------------------------------------------
+
+#include "ivgenerator.h"
+#include "serialparser.h"
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <getopt.h>
+#include <iterator>
+#include <random>
+#include <string>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <thread>
+#include <unistd.h>
+
+// Set by the signal handler, polled between lines.
+static volatile std::sig_atomic_t StopRequested = 0;
+
+// ---------------------------------------------------------------------------
+//  EmulatorSettings:
+//  Command line configuration of the emulator.
+// ---------------------------------------------------------------------------
+struct EmulatorSettings
+{
+    bool redLED = false;             // emulated diode, silicon or red LED
+    std::size_t pointsPerSweep = 50; // DATA lines per sweep
+    double noise = 0.0;              // standard deviation of the current noise (mA)
+    double spread = 0.0;             // relative device spread of Is and Rs
+    double temperature = 300.15;     // diode temperature (K)
+    double sweepRate = 1.0;          // sweeps per second, 0 = unthrottled
+    int corruptEvery = 0;            // replace every N-th line, 0 = never
+    long sweepCount = 0;             // stop after N sweeps, 0 = unlimited
+    unsigned seed = 1;               // noise and corruption random seed
+    std::string linkPath;            // optional symlink to the slave device
+};
+
+// ---------------------------------------------------------------------------
+//  Requests a clean shutdown on SIGINT/SIGTERM.
+// ---------------------------------------------------------------------------
+static void OnStopSignal(int)
+{
+    StopRequested = 1;
+}
+
+// ---------------------------------------------------------------------------
+//  Prints the command line help.
+// ---------------------------------------------------------------------------
+static void PrintUsage(const char *program)
+{
+    std::fprintf(stderr,
+        "Usage: %s [options]\n"
+        "Emulates a DiodeScout device on a pseudo terminal.\n\n"
+        "  -r, --rate <sweeps/s>   Sweep rate, 0 = as fast as possible (default: 1)\n"
+        "  -m, --model <name>      Emulated diode, silicon or led (default: silicon)\n"
+        "  -p, --points <N>        Data points per sweep, 1-%zu (default: 50)\n"
+        "  -e, --noise <mA>        Standard deviation of the current noise (default: 0)\n"
+        "  -d, --spread <ratio>    Relative device spread of Is and Rs (default: 0)\n"
+        "  -t, --temperature <K>   Diode temperature (default: 300.15)\n"
+        "  -x, --corrupt <N>       Replace every N-th line by malformed input (default: 0 = off)\n"
+        "  -n, --count <N>         Stop after N sweeps (default: unlimited)\n"
+        "  -s, --seed <N>          Random seed for noise and corruption (default: 1)\n"
+        "  -l, --link <path>       Create a symlink to the emulated device\n"
+        "  -h, --help              Show this help\n",
+        program, HighResolutionSerialLimits::MaxPointsCount);
+}
+
+// ---------------------------------------------------------------------------
+//  Parses the command line. Returns false on invalid arguments.
+// ---------------------------------------------------------------------------
+static bool ParseArguments(int argc, char *argv[], EmulatorSettings &settings)
+{
+    static const option Options[] = {
+        {"rate", required_argument, nullptr, 'r'},
+        {"model", required_argument, nullptr, 'm'},
+        {"points", required_argument, nullptr, 'p'},
+        {"noise", required_argument, nullptr, 'e'},
+        {"spread", required_argument, nullptr, 'd'},
+        {"temperature", required_argument, nullptr, 't'},
+        {"corrupt", required_argument, nullptr, 'x'},
+        {"count", required_argument, nullptr, 'n'},
+        {"seed", required_argument, nullptr, 's'},
+        {"link", required_argument, nullptr, 'l'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0},
+    };
+
+    int opt = 0;
+    while ((opt = getopt_long(argc, argv, "r:m:p:e:d:t:x:n:s:l:h", Options, nullptr)) != -1)
+    {
+        char *end = nullptr;
+        switch (opt)
+        {
+        case 'r':
+            settings.sweepRate = std::strtod(optarg, &end);
+            if (*end != '\0' || !(settings.sweepRate >= 0.0))
+                return false;
+            break;
+        case 'm':
+            settings.redLED = (std::strcmp(optarg, "led") == 0);
+            if (!settings.redLED && std::strcmp(optarg, "silicon") != 0)
+                return false;
+            break;
+        case 'p':
+            settings.pointsPerSweep = std::strtoul(optarg, &end, 10);
+            if (*end != '\0' || settings.pointsPerSweep < 1 ||
+                settings.pointsPerSweep > HighResolutionSerialLimits::MaxPointsCount)
+                return false;
+            break;
+        case 'e':
+            settings.noise = std::strtod(optarg, &end);
+            if (*end != '\0' || !(settings.noise >= 0.0))
+                return false;
+            break;
+        case 'd':
+            settings.spread = std::strtod(optarg, &end);
+            if (*end != '\0' || !(settings.spread >= 0.0))
+                return false;
+            break;
+        case 't':
+            settings.temperature = std::strtod(optarg, &end);
+            if (*end != '\0' || !(settings.temperature > 0.0))
+                return false;
+            break;
+        case 'x':
+            settings.corruptEvery = static_cast<int>(std::strtol(optarg, &end, 10));
+            if (*end != '\0' || settings.corruptEvery < 0)
+                return false;
+            break;
+        case 'n':
+            settings.sweepCount = std::strtol(optarg, &end, 10);
+            if (*end != '\0' || settings.sweepCount < 0)
+                return false;
+            break;
+        case 's':
+            settings.seed = static_cast<unsigned>(std::strtoul(optarg, &end, 10));
+            if (*end != '\0')
+                return false;
+            break;
+        case 'l':
+            settings.linkPath = optarg;
+            break;
+        default:
+            return false;
+        }
+    }
+
+    return optind == argc;
+}
+
+// ---------------------------------------------------------------------------
+//  Creates the pseudo terminal. Returns the master file descriptor (or -1)
+//  and fills slaveFd with an open descriptor of the slave side in raw mode.
+//  Keeping the slave open ensures that writes to the master do not fail
+//  while no client has the device open.
+// ---------------------------------------------------------------------------
+static int OpenPseudoTerminal(int &slaveFd, std::string &slavePath)
+{
+    const int masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (masterFd < 0)
+        return -1;
+
+    const char *name = nullptr;
+    if (grantpt(masterFd) != 0 || unlockpt(masterFd) != 0 || (name = ptsname(masterFd)) == nullptr)
+    {
+        close(masterFd);
+        return -1;
+    }
+
+    slavePath = name;
+    slaveFd = open(name, O_RDWR | O_NOCTTY);
+    if (slaveFd < 0)
+    {
+        close(masterFd);
+        return -1;
+    }
+
+    // No echo, no CR/LF translation: the client sees the bytes as sent
+    termios tio{};
+    if (tcgetattr(slaveFd, &tio) == 0)
+    {
+        cfmakeraw(&tio);
+        tcsetattr(slaveFd, TCSANOW, &tio);
+    }
+
+    return masterFd;
+}
+
+// ---------------------------------------------------------------------------
+//  Writes the complete buffer, retrying on partial writes and interrupts.
+//  Returns false if the terminal was closed or a stop was requested.
+// ---------------------------------------------------------------------------
+static bool WriteAll(int fd, const char *data, std::size_t size)
+{
+    while (size > 0 && !StopRequested)
+    {
+        const ssize_t written = write(fd, data, size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+
+    return size == 0;
+}
+
+// ---------------------------------------------------------------------------
+//  Application entry point.
+// ---------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Malformed input injected with --corrupt, exercises the parser's
+    // error paths (number format, field count, range, line length).
+    static const char *const Malformed[] = {
+        "DATA 0.5x 1.0",
+        "DATA 1.0",
+        "DATA 99.0 1.0",
+        "GARBAGE-GARBAGE-GARBAGE-GARBAGE-GARBAGE-GARBAGE-GARBAGE-GARBAGE-GARBAGE-GARBAGE-GARBAGE-GARBAGE",
+    };
+
+    EmulatorSettings settings;
+    if (!ParseArguments(argc, argv, settings))
+    {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    int slaveFd = -1;
+    std::string slavePath;
+    const int masterFd = OpenPseudoTerminal(slaveFd, slavePath);
+    if (masterFd < 0)
+    {
+        std::fprintf(stderr, "Cannot create pseudo terminal: %s\n", std::strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    if (!settings.linkPath.empty())
+    {
+        unlink(settings.linkPath.c_str());
+        if (symlink(slavePath.c_str(), settings.linkPath.c_str()) != 0)
+        {
+            std::fprintf(stderr, "Cannot create %s: %s\n", settings.linkPath.c_str(), std::strerror(errno));
+            return EXIT_FAILURE;
+        }
+    }
+
+    // No SA_RESTART, a blocking write must return when stopping
+    struct sigaction stopAction{};
+    stopAction.sa_handler = OnStopSignal;
+    sigaction(SIGINT, &stopAction, nullptr);
+    sigaction(SIGTERM, &stopAction, nullptr);
+
+    // The device path goes to stdout, so scripts can capture it
+    std::printf("%s\n", settings.linkPath.empty() ? slavePath.c_str() : settings.linkPath.c_str());
+    std::fflush(stdout);
+
+    IVGeneratorSettings curve = settings.redLED ? IVGeneratorSettings::RedLED() : IVGeneratorSettings::SiliconDiode();
+    curve.model.temperature = settings.temperature;
+    curve.pointsPerSeries = settings.pointsPerSweep;
+    curve.parameterSpread = settings.spread;
+    curve.currentNoise = settings.noise;
+    curve.seed = settings.seed;
+
+    IVGenerator generator(curve);
+    MeasurementSeries sweep;
+    std::mt19937 random(settings.seed);
+
+    // Lines are spread evenly over the sweep period
+    const std::size_t linesPerSweep = settings.pointsPerSweep + 2;
+    const Clock::duration linePeriod = settings.sweepRate > 0.0
+        ? std::chrono::duration_cast<Clock::duration>(
+              std::chrono::duration<double>(1.0 / (settings.sweepRate * linesPerSweep)))
+        : Clock::duration::zero();
+
+    unsigned long long lineCount = 0;
+    unsigned long long byteCount = 0;
+    long sweeps = 0;
+    const auto start = Clock::now();
+    auto nextLine = start;
+
+    std::string line;
+    char data[64];
+
+    auto sendLine = [&](const char *text)
+    {
+        ++lineCount;
+        if (settings.corruptEvery > 0 && lineCount % settings.corruptEvery == 0)
+            line = Malformed[random() % std::size(Malformed)];
+        else
+            line = text;
+        line += "\r\n";
+
+        if (linePeriod > Clock::duration::zero())
+        {
+            std::this_thread::sleep_until(nextLine);
+            nextLine += linePeriod;
+        }
+
+        byteCount += line.size();
+        return WriteAll(masterFd, line.data(), line.size());
+    };
+
+    bool ok = true;
+    while (ok && !StopRequested && (settings.sweepCount == 0 || sweeps < settings.sweepCount))
+    {
+        generator.generate(sweep);
+
+        ok = sendLine("BEGIN");
+        for (std::size_t p = 0; ok && p < sweep.size(); ++p)
+        {
+            std::snprintf(data, sizeof(data), "DATA %.3f %.3f", sweep.voltages()[p], sweep.currents()[p]);
+            ok = sendLine(data);
+        }
+        ok = ok && sendLine("END");
+
+        if (ok)
+            ++sweeps;
+    }
+
+    // Let the client read the remaining data before the terminal is closed.
+    // Data still in transit to the slave is not reported by FIONREAD, so
+    // the input queue has to stay empty for several polls.
+    for (int idlePolls = 0; ok && !StopRequested && idlePolls < 10;)
+    {
+        int pending = 0;
+        if (ioctl(slaveFd, FIONREAD, &pending) != 0)
+            break;
+        idlePolls = (pending > 0) ? 0 : idlePolls + 1;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::fprintf(stderr, "%ld sweeps, %llu lines, %llu bytes in %.3f s (%.1f sweeps/s, %.1f kB/s)\n", sweeps,
+        lineCount, byteCount, seconds, seconds > 0.0 ? sweeps / seconds : 0.0,
+        seconds > 0.0 ? byteCount / seconds / 1e3 : 0.0);
+
+    if (!settings.linkPath.empty())
+        unlink(settings.linkPath.c_str());
+    close(slaveFd);
+    close(masterFd);
+    return ok || StopRequested ? EXIT_SUCCESS : EXIT_FAILURE;
+}